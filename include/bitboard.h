@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frontera.h"
+
+// Modo de combinar un patrón con el contenido del tablero
+enum class StampMode {
+  overwrite, // el patrón sustituye al contenido
+  bitOr,     // solo añade células vivas
+  bitXor     // invierte las células vivas del patrón
+};
+
+// Retículo empaquetado: un bit por célula, 64 células por palabra.
+//
+// Cada fila ocupa getStride() palabras y el tablero guarda, igual que Lattice,
+// un halo de una célula alrededor del interior. La columna j (de -1 a cols) está
+// en el bit (j + 64) de la fila, de modo que la palabra 0 solo contiene la
+// columna -1 en su bit 63 y el interior empieza en la palabra 1. Las filas -1 y
+// rows son las filas del halo.
+class Bitboard {
+public:
+  Bitboard();
+  Bitboard(int rows, int cols);
+
+  // dimensiones del interior
+  int getRows() const;
+  int getCols() const;
+
+  // palabras interiores por fila y palabras totales por fila
+  int getWords() const;
+  int getStride() const;
+
+  // puntero a la palabra 0 de la fila i, con i en [-1, rows]
+  std::uint64_t* row(int i);
+  const std::uint64_t* row(int i) const;
+
+  // acceso a una célula, admite el halo. No comprueba los límites salvo en
+  // las compilaciones de depuración (make debug), donde se usa assert
+  bool get(int i, int j) const;
+  void set(int i, int j, bool state);
+
+  // poner todas las células (halo incluido) a muertas
+  void clear();
+
+  // añadir filas y columnas muertas por cada lado, conservando el contenido
+  void grow(int top, int left, int bottom, int right);
+
+  // Edición por regiones, palabra a palabra. Lo que cae fuera del interior se recorta.
+  // stamp copia el interior de pattern con su esquina superior izquierda en (row, col)
+  void stamp(const Bitboard& pattern, int row, int col, StampMode mode);
+  // poner a state el rectángulo [rowBegin, rowEnd) x [colBegin, colEnd)
+  void fillRect(int rowBegin, int colBegin, int rowEnd, int colEnd, bool state);
+
+  // número de células vivas del interior
+  std::size_t population() const;
+  // células vivas de la fila i en las columnas [colBegin, colEnd), con popcount por palabra
+  int countRange(int i, int colBegin, int colEnd) const;
+
+  // Rectángulo mínimo [rowBegin, rowEnd) x [colBegin, colEnd) con todas las células
+  // vivas del interior. Devuelve false si no hay ninguna
+  bool boundingBox(int& rowBegin, int& colBegin, int& rowEnd, int& colEnd) const;
+
+  // máscara de las columnas válidas de la última palabra interior
+  std::uint64_t lastWordMask() const;
+
+  // rellenar el halo según la frontera
+  void fillHalo(Frontera frontera);
+
+  // calcular la siguiente generación del interior en next. stepRegion solo
+  // calcula las filas [rowBegin, rowEnd) y las palabras interiores [wordBegin, wordEnd)
+  void step(Bitboard& next) const;
+  void stepRegion(Bitboard& next, int rowBegin, int rowEnd, int wordBegin, int wordEnd) const;
+
+  void swap(Bitboard& other);
+
+private:
+  int rows_;
+  int cols_;
+  int words_;
+  int stride_;
+  std::vector<std::uint64_t> bits_;
+};
+
+// Accesos en línea para que los núcleos de cálculo no paguen una llamada por célula
+
+inline std::uint64_t* Bitboard::row(int i) {
+  assert(i >= -1 && i <= rows_);
+  return bits_.data() + static_cast<std::size_t>(i + 1) * stride_;
+}
+
+inline const std::uint64_t* Bitboard::row(int i) const {
+  assert(i >= -1 && i <= rows_);
+  return bits_.data() + static_cast<std::size_t>(i + 1) * stride_;
+}
+
+inline bool Bitboard::get(int i, int j) const {
+  assert(j >= -1 && j <= cols_);
+  const int bit = j + 64;
+  return (row(i)[bit >> 6] >> (bit & 63)) & 1;
+}
+
+inline void Bitboard::set(int i, int j, bool state) {
+  assert(j >= -1 && j <= cols_);
+  const int bit = j + 64;
+  const std::uint64_t mask = std::uint64_t(1) << (bit & 63);
+  if (state) {
+    row(i)[bit >> 6] |= mask;
+  } else {
+    row(i)[bit >> 6] &= ~mask;
+  }
+}
+
+inline int Bitboard::countRange(int i, int colBegin, int colEnd) const {
+  assert(colBegin >= -1 && colBegin < colEnd && colEnd <= cols_ + 1);
+  const std::uint64_t* r = row(i);
+  const int first = colBegin + 64;
+  const int last = colEnd + 63; // último bit incluido
+  const int firstWord = first >> 6;
+  const int lastWord = last >> 6;
+  const std::uint64_t headMask = ~std::uint64_t(0) << (first & 63);
+  const std::uint64_t tailMask = ~std::uint64_t(0) >> (63 - (last & 63));
+  if (firstWord == lastWord) {
+    return __builtin_popcountll(r[firstWord] & headMask & tailMask);
+  }
+  int count = __builtin_popcountll(r[firstWord] & headMask);
+  for (int k = firstWord + 1; k < lastWord; ++k) {
+    count += __builtin_popcountll(r[k]);
+  }
+  return count + __builtin_popcountll(r[lastWord] & tailMask);
+}
@@ -39,6 +39,8 @@ public:
 
   // funcion de transicion
   State transitionFunction(std::vector<Cell> neighbors);
+  State transitionFunction(int aliveCount) const;
+  static State transitionFunction(State state, int aliveCount); // en línea, para los núcleos
 
   // Sobrecarga del operador<<
   friend std::ostream& operator<<(std::ostream& os, const Cell& cell);
@@ -48,3 +50,10 @@ private:
   State state_;       // Estado de la célula
   State nextState_;
 };
+
+// La regla se define en línea para que el bucle de ScalarEngine::step pueda vectorizarse
+inline State Cell::transitionFunction(State state, int aliveCount) {
+  // Lógica de la funcion de transicion
+  // viva con 2 o 3 vecinos, o muerta con 3; sin ramas para que se pueda vectorizar
+  return (aliveCount == 3) | (state & (aliveCount == 2));
+}
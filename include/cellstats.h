@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+
+// Estadísticas de análisis que los núcleos actualizan en la misma pasada en la
+// que calculan la siguiente generación, fila a fila:
+//  - edad de cada célula: generaciones seguidas viva, con saturación en 255
+//  - actividad por baldosa de kTile x kTile células: en cuántas generaciones ha
+//    cambiado alguna de sus células
+// Solo existen si se piden; sin ellas los núcleos no hacen ningún trabajo extra.
+class CellStats {
+public:
+  static const int kTile = 64;
+
+  // Empieza con edad 1 para las células vivas del tablero y actividad a cero
+  explicit CellStats(const Bitboard& board);
+
+  int getRows() const;
+  int getCols() const;
+  std::size_t getGenerations() const;
+
+  // La fila i ha pasado de oldRow a newRow (filas empaquetadas de Bitboard,
+  // con la palabra 0 del halo). Se llama una vez por fila y generación
+  void updateRow(int i, const std::uint64_t* oldRow, const std::uint64_t* newRow);
+  // cerrar la generación: sumar la actividad de las baldosas que han cambiado
+  void endGeneration();
+
+  // Se ha editado el rectángulo [rowBegin, rowEnd) x [colBegin, colEnd) de board
+  // fuera de los núcleos: las células que han cambiado de estado empiezan de
+  // nuevo su edad y su baldosa cuenta como activa en el siguiente endGeneration
+  void editRect(const Bitboard& board, int rowBegin, int colBegin, int rowEnd, int colEnd);
+
+  // el tablero ha crecido (frontera noBorder) con filas y columnas por cada lado
+  void grow(int top, int left, int bottom, int right);
+
+  std::uint8_t age(int i, int j) const;
+  std::uint32_t activity(int tileRow, int tileCol) const;
+
+  // Exportar: PGM (edad tal cual; actividad escalada a 0..255 con el máximo) o
+  // binario (cabecera "LGAGE1"/"LGACT1", u32 filas, u32 columnas y los datos)
+  bool writeAgePgm(const char* filename) const;
+  bool writeActivityPgm(const char* filename) const;
+  bool writeAgeBinary(const char* filename) const;
+  bool writeActivityBinary(const char* filename) const;
+
+private:
+  int rows_;
+  int cols_;
+  int words_;
+  int tileRows_;
+  int tileCols_;
+  std::size_t generations_;
+  std::vector<std::uint8_t> age_;
+  std::vector<std::uint32_t> activity_;
+  std::vector<std::uint8_t> changed_; // baldosas que han cambiado en esta generación
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "frontera.h"
+#include "transport.h"
+
+// Retículo repartido entre varios procesos de la misma máquina.
+//
+// El tablero se divide en una rejilla procRows x procCols de sub-retículos
+// empaquetados (Bitboard) y cada uno pertenece a un proceso trabajador. En cada
+// generación los trabajadores intercambian una columna y una fila de halo con
+// sus vecinos por el transporte elegido, mientras calculan el interior de su
+// bloque. Este objeto hace de coordinador: reparte las órdenes y reúne los
+// resultados, pero nunca guarda el tablero completo.
+class DistributedLattice {
+public:
+  // Cada trabajador lee su bloque directamente del fichero (formato de saveToFile)
+  DistributedLattice(const char* filename, int procRows, int procCols, Frontera frontera, TransportKind kind);
+
+  // Detiene y espera a los trabajadores
+  ~DistributedLattice();
+
+  // false si no se pudo leer el fichero o arrancar los trabajadores
+  bool isReady() const;
+
+  int getRows() const;
+  int getCols() const;
+
+  // calcular las siguientes generaciones
+  void nextGeneration(int generations = 1);
+
+  // Conocer poblacion (reducción de los contadores de todos los trabajadores)
+  std::size_t Population() const;
+
+  // guardar a un archivo; cada trabajador escribe sus filas en paralelo
+  void saveToFile(const char* filename) const;
+
+private:
+  // enviar la misma orden a todos los trabajadores y recoger sus respuestas
+  bool broadcast(int op, std::int64_t arg, const char* path, std::vector<std::int64_t>& replies) const;
+
+  int rows;                  // filas del tablero completo
+  int cols;                  // columnas del tablero completo
+  int procRows_;
+  int procCols_;
+  std::size_t headerBytes_;  // longitud de la cabecera "rows cols\n"
+  bool ready_;
+  std::vector<pid_t> workers_;
+  std::vector<int> control_; // canal de órdenes con cada trabajador
+};
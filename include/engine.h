@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+#include "cellstats.h"
+#include "lutkernel.h"
+#include "rule.h"
+
+// Núcleos de cálculo intercambiables detrás de Lattice::step()
+enum class EngineKind {
+  scalar,    // tres filas desempaquetadas a bytes, vectorizado por el compilador
+  bitSliced, // árbol de sumadores sobre palabras de 64 células
+  lut,       // tabla de bloques 2x2; el único que admite cualquier regla B/S
+  tiled,     // bit-sliced solo en las baldosas con vecindario que ha cambiado
+  adaptive   // elige uno de los anteriores según cómo evoluciona el tablero
+};
+
+// Convierte el nombre del núcleo (scalar, bitsliced, lut, tiled o auto).
+// Devuelve false si no es válido.
+bool parseEngine(const std::string& nombre, EngineKind& kind);
+
+// Nombre del núcleo, tal y como se escribe en la línea de comandos
+std::string engineToString(EngineKind kind);
+
+// Un núcleo calcula en next la generación siguiente del interior de board, cuyo
+// halo ya está relleno, y con stats anota cada fila en cuanto la termina.
+class Engine {
+public:
+  virtual ~Engine() {}
+
+  virtual EngineKind kind() const = 0;
+  virtual void step(const Bitboard& board, Bitboard& next, CellStats* stats) = 0;
+
+  // El tablero ha cambiado fuera del núcleo (ediciones, crecimiento, cambio de
+  // núcleo): se descarta lo que el núcleo recuerde de la generación anterior
+  virtual void reset() {}
+};
+
+// Crear un núcleo concreto (no adaptive). scalar, bitSliced y tiled solo
+// implementan B3/S23
+std::unique_ptr<Engine> makeEngine(EngineKind kind, const Rule& rule);
+
+// Muestra que toma la política adaptativa cada cierto número de generaciones
+struct EngineSample {
+  double density;         // células vivas / células del tablero
+  double changedTiles;    // fracción de baldosas de 64x64 que han cambiado
+  double boundingBoxArea; // área de la caja de las células vivas / área del tablero
+  double boundingBoxGrowth; // área de la caja respecto a la muestra anterior
+};
+
+// Fracción de baldosas de CellStats::kTile x kTile que difieren entre before y after
+double changedTileFraction(const Bitboard& before, const Bitboard& after);
+
+// Política con histéresis: solo cambia de núcleo si la misma alternativa sale
+// ganadora en dos muestras seguidas, y los umbrales para entrar y salir del
+// núcleo por baldosas están separados
+class EnginePolicy {
+public:
+  explicit EnginePolicy(const Rule& rule);
+
+  // Núcleo recomendado tras la muestra; current es el que está en uso
+  EngineKind decide(EngineKind current, const EngineSample& sample);
+
+private:
+  EngineKind preferred(EngineKind current, const EngineSample& sample) const;
+
+  bool conway_;
+  EngineKind candidate_;
+  int votes_;
+};
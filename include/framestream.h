@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+
+// Formato de los fotogramas
+enum class FrameFormat {
+  pbm, // P4: un bit por célula, 1 = viva
+  pgm  // P5: un byte por bloque zoom x zoom, densidad de 0 a 255
+};
+
+// Convierte el nombre del formato (pbm o pgm). Devuelve false si no es válido.
+bool parseFrameFormat(const std::string& nombre, FrameFormat& format);
+
+// Flujo de fotogramas binarios (PBM/PGM concatenados) hacia un fichero o una
+// tubería, para montar animaciones sin pasar por el texto de la salida estándar.
+// Cada fotograma se compone en un búfer reutilizado y sale con un solo writev
+// junto con su cabecera.
+class FrameStream {
+public:
+  // every: se escribe una de cada every generaciones. zoom solo se usa con pgm
+  FrameStream(const char* filename, FrameFormat format, int every, int zoom = 1);
+  ~FrameStream();
+
+  bool isOpen() const;
+
+  // escribir el tablero si a la generación le toca fotograma
+  void write(std::size_t generation, const Bitboard& board);
+
+private:
+  void writePbm(const Bitboard& board);
+  void writePgm(const Bitboard& board);
+  void writeFrame(const std::string& header);
+
+  int fd_;
+  FrameFormat format_;
+  int every_;
+  int zoom_;
+  std::vector<unsigned char> staging_; // cuerpo del fotograma
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+// Tipos de frontera soportados por el retículo. Se interpretan una sola vez a
+// partir de la línea de comandos y el resto del programa trabaja con el enum.
+enum class Frontera {
+  periodic,        // el retículo se cierra sobre sí mismo (toroide)
+  noBorder,        // el retículo crece cuando una célula viva llega al borde
+  abiertaFria,     // rodeado de células muertas
+  abiertaCaliente  // rodeado de células vivas
+};
+
+// Convierte el nombre de la frontera en su valor. Devuelve false si no es válido.
+bool parseFrontera(const std::string& nombre, Frontera& frontera);
+
+// Nombre de la frontera, tal y como se escribe en la línea de comandos
+std::string fronteraToString(Frontera frontera);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+
+// Historial de generaciones en disco.
+//
+// El fichero es un registro de solo escritura al final: una cabecera y después
+// un registro por generación. Cada keyframeInterval generaciones (o cuando cambia
+// el tamaño del tablero) se guarda el interior empaquetado completo; en medio solo
+// el XOR con la generación anterior, comprimido por rachas de palabras a cero.
+// Al cerrar se añade un índice de los fotogramas completos. Si el fichero no llegó
+// a cerrarse, el lector reconstruye el índice recorriendo los registros.
+
+// Escritor: solo guarda en memoria la generación anterior
+class HistoryWriter {
+public:
+  HistoryWriter(const char* filename, int keyframeInterval);
+  ~HistoryWriter();
+
+  bool isOpen() const;
+
+  // añadir el estado del tablero en la generación dada
+  void append(std::size_t generation, const Bitboard& board);
+
+  // escribir el índice y cerrar el fichero
+  void close();
+
+private:
+  void writeRecord(std::uint8_t type, std::size_t generation, const Bitboard& board,
+                   const std::vector<char>& payload);
+
+  std::ofstream file_;
+  int keyframeInterval_;
+  bool hasPrevious_;
+  std::size_t previousGeneration_;
+  std::size_t lastKeyframe_;
+  Bitboard previous_;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> index_; // (generación, posición) de los fotogramas completos
+};
+
+// Lector con acceso aleatorio: seek() parte del fotograma completo anterior y
+// aplica como mucho keyframeInterval - 1 deltas
+class HistoryReader {
+public:
+  HistoryReader(const char* filename);
+
+  bool isOpen() const;
+
+  // primera y última generación guardadas
+  std::size_t firstGeneration() const;
+  std::size_t lastGeneration() const;
+
+  // reconstruir la generación pedida. Devuelve false si no está en el historial
+  bool seek(std::size_t generation, Bitboard& board);
+
+private:
+  bool scanRecords();
+
+  std::ifstream file_;
+  bool open_;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> index_;
+  std::size_t lastGeneration_;
+};
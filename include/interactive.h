@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+#include "lattice.h"
+#include "viewport.h"
+
+// Modo interactivo en el terminal.
+//
+// Un hilo de simulación calcula generaciones sin parar, a un ritmo objetivo o
+// lo más rápido posible, y es el único que toca el retículo. El hilo de la
+// interfaz lee las teclas sin bloquearse y dibuja la última generación terminada,
+// que el simulador le entrega en un fotograma doble: escribe en uno mientras la
+// interfaz dibuja el otro. Pausa, paso a paso, cambios de ritmo y guardado son
+// órdenes que el simulador aplica entre dos generaciones, así la interfaz
+// responde aunque una generación tarde segundos.
+class InteractiveSession {
+public:
+  // rate: generaciones por segundo (0 = sin límite)
+  InteractiveSession(Lattice& lattice, double rate);
+
+  // Bucle de la interfaz; vuelve cuando el usuario sale
+  int run();
+
+private:
+  // Generación terminada, lista para dibujar
+  struct Frame {
+    Bitboard board;
+    std::size_t generation = 0;
+    std::size_t population = 0;
+  };
+
+  void simulationLoop();
+  void publishFrame();
+  bool frameOutdated();
+  void draw(const Frame& frame);
+  bool handleKey(char key);
+  bool handleViewKey(char key);
+  std::string askFileName();
+
+  Lattice& lattice_;
+
+  // Órdenes para el simulador, protegidas por mutex_
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool paused_;
+  int pendingSteps_;
+  double rate_;
+  bool quit_;
+  std::vector<std::string> pendingSaves_;
+  std::string message_; // última noticia del simulador para la línea de estado
+
+  // Fotogramas: back_ es del simulador, front_ se intercambia bajo frameMutex_
+  // y display_ es el que dibuja la interfaz
+  std::mutex frameMutex_;
+  Frame back_;
+  Frame front_;
+  Frame display_;
+  bool frameReady_;  // hay un fotograma nuevo en front_
+  bool frameWanted_; // la interfaz ya consumió el anterior
+  std::size_t lastPublished_; // generación del último fotograma entregado
+  bool popMode_;
+
+  // Ventana que dibuja la interfaz; solo la toca el hilo de la interfaz
+  Viewport view_;
+  bool fitted_;   // la ventana ya se ajustó al primer fotograma
+  int viewRows_;  // líneas del terminal dedicadas al tablero
+  int viewCols_;
+};
@@ -1,27 +1,39 @@
 #pragma once
 
 #include <iostream>
+#include <cstdint>
 #include "cell.h" // Incluir el archivo de encabezado de la clase Cell
+#include "frontera.h"
+#include "bitboard.h"
+#include "engine.h"
+#include <memory>
+#include <string>
 #include <vector>
 #include <utility> // Para utilizar std::pair
 #include <algorithm> // Para std::find
 
 // Declaracion adelantada de la clase Cell
 class Cell;
+class HistoryWriter;
+class FrameStream;
 
 // Definición de la clase Lattice
 class Lattice {
 public:
-    // Constructor que crea las células en memoria dinámica con valor inicial de estado muerta
+    // Constructor que crea las células con valor inicial de estado muerta
     Lattice(int N, int M);
     Lattice(const char* filename);
     Lattice(int once);
+    // Constructor con una sopa aleatoria reproducible
+    Lattice(int N, int M, std::uint64_t seed, double density);
+    // Constructor a partir de un tablero ya empaquetado (p. ej. leído del historial)
+    Lattice(const Bitboard& board, std::size_t generation);
 
-    // Destructor para liberar la memoria de las células
+    // Destructor
     ~Lattice();
 
-    std::string getFrontera() const;
-    void setFrontera(const std::string& frontera);
+    Frontera getFrontera() const;
+    void setFrontera(Frontera frontera);
 
     // getters rows y cols
     int getRows() const;
@@ -34,36 +46,120 @@ public:
     // Pedir celulas vivas
     void askForLiveCells();
 
+    // Sopa aleatoria en el rectángulo [rowBegin, rowEnd) x [colBegin, colEnd)
+    void randomSoup(std::uint64_t seed, double density, int rowBegin, int colBegin, int rowEnd, int colEnd,
+                    int threads = 0);
+
     // Conocer poblacion
     std::size_t Population() const;
 
-    // Condiciones de frontera
-    void noFrontier(int i, int j);
-    void periodicFrontier();
-    void openFrontier(const bool temp);
-    void removeBorders();
+    // Generaciones calculadas desde que se creó el retículo
+    std::size_t getGeneration() const;
+
+    // Tablero empaquetado de la generación actual
+    const Bitboard& getBoard() const;
+
+    // Error al leer el fichero de Lattice(const char*); vacío si se cargó bien
+    const std::string& getLoadError() const;
+
+    // Historial donde se añade cada generación calculada (nullptr = ninguno).
+    // El retículo no se hace cargo de él
+    void setHistory(HistoryWriter* history);
+    // Igual para el flujo de fotogramas PBM/PGM
+    void setFrameStream(FrameStream* frames);
+
+    // Núcleo de cálculo y regla. Con EngineKind::adaptive, cada sampleInterval
+    // generaciones se mide el tablero y se pasa al núcleo más barato; los
+    // cambios se anotan en std::cerr. Solo lut admite reglas distintas de B3/S23
+    void setEngine(EngineKind kind, const Rule& rule, int sampleInterval = 32);
+    // núcleo en uso (con adaptive, el elegido ahora mismo)
+    EngineKind getEngine() const;
+
+    // Edad de las células y actividad por baldosas, actualizadas por el núcleo
+    // (nullptr = sin estadísticas). El retículo no se hace cargo de ellas
+    void setStats(CellStats* stats);
 
-    // actualizador de posiciones
-    void updatePositions();
+    // Edición por regiones sobre el tablero empaquetado, sin pasar por cada célula
+    void stamp(const Bitboard& pattern, int row, int col, StampMode mode);
+    void fillRect(int rowBegin, int colBegin, int rowEnd, int colEnd, State state);
+
+    // Ediciones en cola: se aplican en orden en el límite de la generación
+    // indicada (al terminar de calcularla) o en el siguiente si ya ha pasado
+    void queueStamp(std::size_t generation, const Bitboard& pattern, int row, int col, StampMode mode);
+    void queueFillRect(std::size_t generation, int rowBegin, int colBegin, int rowEnd, int colEnd, State state);
+    void applyPendingEdits();
+
+    // Condiciones de frontera: rellenar el halo según la frontera activa
+    // y, en modo noBorder, hacer crecer el retículo
+    void fillHalo();
+    void growBorders();
 
     // actualizador de estados
     void updateStates();
 
-    // calculo siguiente generacion
+    // calculo siguiente generacion: step() solo calcula, nextGeneration() además
+    // imprime el tablero o la población
+    void step();
     void nextGeneration();
 
     // guardar a un archivo
     void saveToFile(const char* filename) const;
 
-    // sobrecarga de operadores
-    Cell& operator[](const Position& pos) const;
+    // Acceso para los núcleos de cálculo: sin comprobación de límites y en línea.
+    // Admite el halo; con make debug los límites se comprueban con assert
+    State at_unchecked(int row, int col) const;
+    const std::uint64_t* rowPointer(int row) const; // palabras empaquetadas de la fila
+
+    // sobrecarga de operadores. Acceso comprobado para el código de usuario:
+    // lanzan std::out_of_range fuera del retículo
+    Cell operator[](const Position& pos) const;
+    Cell haloAt(int row, int col) const; // admite las filas/columnas -1 y rows/cols
     friend std::ostream& operator<<(std::ostream& os, const Lattice& lattice);
     Lattice& operator=(const Lattice& other);
 
 private:
+    // medir el tablero y, si la política lo pide, cambiar de núcleo
+    void adaptEngine(double changedTiles);
+
+    // Edición pendiente: un patrón estampado o un rectángulo relleno
+    struct Edit {
+        std::size_t generation;
+        bool isStamp;
+        Bitboard pattern;
+        int row;
+        int col;
+        int rowEnd;
+        int colEnd;
+        StampMode mode;
+        State state;
+    };
+
     int rows;                  // Ancho de la retícula
     int cols;                 // Altura de la retícula
-    std::vector<std::vector<Cell*>> cells_;   // Vector de punteros a células
-    std::string frontera_;
+    // Células empaquetadas a un bit, con un halo permanente de una célula
+    // alrededor del retículo. next_ recibe la generación siguiente
+    Bitboard board_;
+    Bitboard next_;
+    Frontera frontera_;
     bool popMode; // modo population
+    std::string loadError_;
+    std::size_t generation_;
+    std::vector<Edit> pendingEdits_;
+    HistoryWriter* history_;
+    FrameStream* frames_;
+    CellStats* stats_;
+    Rule rule_;
+    std::unique_ptr<Engine> engine_;
+    std::unique_ptr<EnginePolicy> policy_; // solo con EngineKind::adaptive
+    int sampleInterval_;
+    double lastBoxArea_;   // caja de las células vivas en la muestra anterior
+    bool edited_;          // el tablero cambió fuera del núcleo desde la última generación
 };
+
+inline State Lattice::at_unchecked(int row, int col) const {
+    return board_.get(row, col);
+}
+
+inline const std::uint64_t* Lattice::rowPointer(int row) const {
+    return board_.row(row);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "bitboard.h"
+#include "cellstats.h"
+#include "rule.h"
+
+// Núcleo por tabla para máquinas sin SIMD: el tablero se recorre en bloques de
+// 2x2 células y los 16 bits del vecindario 4x4 de cada bloque indexan una tabla
+// de 64 KiB con los 4 bits del bloque en la generación siguiente. No hay ninguna
+// rama por célula ni llamadas a Cell::transitionFunction. La tabla se genera al
+// construir el núcleo a partir de la regla, así sirve para cualquier regla B/S.
+//
+// Índice: bits 4r..4r+3 = fila r del vecindario (columnas j-1..j+2, de la menos
+// a la más significativa). Resultado: bit 0 (i, j), bit 1 (i, j+1),
+// bit 2 (i+1, j) y bit 3 (i+1, j+1).
+class LutKernel {
+public:
+  explicit LutKernel(const Rule& rule);
+
+  const Rule& getRule() const;
+
+  // calcular en next la generación siguiente del interior de board, cuyo halo
+  // tiene que estar ya relleno. Con stats, cada par de filas se anota al acabarlo
+  void step(const Bitboard& board, Bitboard& next, CellStats* stats = nullptr) const;
+
+private:
+  Rule rule_;
+  std::vector<std::uint8_t> table_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bitboard.h"
+#include "frontera.h"
+
+// Retículo fuera de memoria para tableros cuyo tamaño empaquetado no cabe en RAM.
+//
+// El tablero vive en un fichero empaquetado (una cabecera de una página y después
+// las palabras interiores de cada fila) proyectado con mmap. Cada generación
+// recorre el tablero en franjas de filas: la franja se copia a un Bitboard con
+// su halo (la última fila de la franja anterior y la primera de la siguiente),
+// se calcula con el núcleo de bits y se escribe en una segunda proyección. Con
+// madvise se pide por adelantado la franja siguiente y se sueltan las ya usadas,
+// así en memoria solo hay una ventana de tres franjas y el disco se lee en orden.
+// Al terminar la generación el fichero nuevo sustituye al anterior.
+class OutOfCoreLattice {
+public:
+  // Convertir un tablero de texto (formato de saveToFile) al formato empaquetado,
+  // fila a fila sin cargarlo entero. Devuelve false si falla
+  static bool convertText(const char* textFile, const char* packedFile);
+
+  // Abrir un fichero empaquetado. bandRows = 0 elige franjas de unos 8 MiB
+  OutOfCoreLattice(const char* packedFile, Frontera frontera, int bandRows = 0);
+  ~OutOfCoreLattice();
+
+  // false si no se pudo abrir el fichero o la frontera no es de tamaño fijo
+  bool isReady() const;
+
+  int getRows() const;
+  int getCols() const;
+  std::size_t getGeneration() const;
+
+  // calcular las siguientes generaciones
+  void nextGeneration(int generations = 1);
+
+  // Conocer poblacion, leyendo el fichero en orden
+  std::size_t Population() const;
+
+  // guardar en texto (formato de saveToFile), fila a fila
+  void saveToFile(const char* filename) const;
+
+private:
+  bool map(const char* filename);
+  void unmap();
+  void step();
+  // copiar la fila row del tablero (o la del halo que le corresponda si está
+  // fuera) a la fila bandRow de band, con sus columnas de halo
+  void loadRow(Bitboard& band, int bandRow, int row) const;
+  const std::uint64_t* packedRow(int row) const;
+
+  std::string filename_;
+  Frontera frontera_;
+  int rows;
+  int cols;
+  int words_;
+  int bandRows_;
+  std::size_t generation_;
+  int fd_;
+  char* map_;
+  std::size_t mapBytes_;
+};
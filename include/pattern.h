@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "bitboard.h"
+
+// Construir un patrón a partir de sus filas ('X' viva, cualquier otro carácter muerta)
+Bitboard makePattern(const std::vector<std::string>& rows);
+
+// Patrones conocidos por nombre: glider, lwss, blinker, block, rpentomino, gosperGun
+bool namedPattern(const std::string& nombre, Bitboard& pattern);
+
+// Leer un patrón de un fichero con el mismo formato que saveToFile. Devuelve false si no es válido
+bool loadPattern(const char* filename, Bitboard& pattern);
+
+// Un nombre conocido o, si no lo es, un fichero
+bool findPattern(const std::string& nombre, Bitboard& pattern);
+
+// Convierte el nombre del modo de estampado (or, xor o set). Devuelve false si no es válido.
+bool parseStampMode(const std::string& nombre, StampMode& mode);
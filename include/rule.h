@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Regla de un autómata "Life-like" en notación B/S: el bit n de birth indica que
+// una célula muerta con n vecinos vivos nace, y el de survive que una viva sobrevive
+struct Rule {
+  std::uint16_t birth = 1 << 3;                 // B3
+  std::uint16_t survive = (1 << 2) | (1 << 3);  // S23
+
+  // siguiente estado de una célula con aliveCount vecinos vivos
+  bool next(bool alive, int aliveCount) const {
+    return ((alive ? survive : birth) >> aliveCount) & 1;
+  }
+
+  bool isConway() const {
+    return birth == (1 << 3) && survive == ((1 << 2) | (1 << 3));
+  }
+};
+
+// Interpreta una regla como "B3/S23" (también "b36/s23"). Devuelve false si no es válida.
+bool parseRule(const std::string& nombre, Rule& rule);
+
+// Regla en notación B/S
+std::string ruleToString(const Rule& rule);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lattice.h"
+
+// Modo servidor: un proceso de larga vida que escucha en un socket de dominio
+// Unix y mantiene en memoria retículos con nombre, así cada experimento se
+// ahorra arrancar el programa y volver a leer el tablero.
+//
+// Protocolo de texto, una orden por línea y una respuesta por orden
+// ("OK ..." o "ERROR ..."):
+//   load <nombre> <fichero> [frontera]          leer un tablero (formato de saveToFile)
+//   random <nombre> <filas> <columnas> <semilla> <densidad> [frontera]
+//   step <nombre> <n>                            calcular n generaciones -> OK <generación>
+//   population <nombre>                          -> OK <células vivas>
+//   bbox <nombre>                                -> OK <r0> <c0> <r1> <c1> | OK vacio
+//   snapshot <nombre> <fichero>                  guardar con saveToFile
+//   stamp <nombre> <patron> <fila> <columna> <modo>
+//   drop <nombre> | list | quit | shutdown
+//
+// Las órdenes se ejecutan en un grupo de hilos. Las de un mismo tablero se
+// serializan en su propia cola, de modo que varios clientes pueden mover
+// tableros distintos en paralelo. Cada cliente recibe sus respuestas en orden:
+// no se lee su siguiente orden hasta contestar la anterior. Las respuestas se
+// acumulan en un búfer por cliente que el bucle principal vacía cuando el socket
+// admite más datos, así un cliente lento no detiene a los demás.
+class SimulationServer {
+public:
+  // threads = 0: un hilo por núcleo
+  SimulationServer(const char* socketPath, int threads = 0);
+  ~SimulationServer();
+
+  // false si no se pudo crear el socket
+  bool isReady() const;
+
+  // bucle de atención a los clientes; vuelve tras la orden shutdown
+  int run();
+
+private:
+  // Tablero con su cola de órdenes: como mucho una se ejecuta a la vez
+  struct Board {
+    std::mutex mutex;
+    std::deque<std::function<void()>> queue;
+    bool running = false;
+    std::unique_ptr<Lattice> lattice;
+  };
+
+  struct Client {
+    int fd;
+    std::string buffer;  // bytes leídos aún sin procesar
+    std::string output;  // respuestas aún sin enviar
+    bool busy = false;   // esperando la respuesta de una orden
+    bool closing = false;
+  };
+
+  void submit(std::function<void()> task);
+  void submitToBoard(const std::shared_ptr<Board>& board, std::function<void()> task);
+  void drainBoard(std::shared_ptr<Board> board);
+  void workerLoop();
+
+  void dispatch(int clientId, const std::string& line);
+  void reply(int clientId, const std::string& text);
+  void finish(int clientId, const std::string& text);
+  void collectFinished();
+  void acceptClient();
+  void readClient(int clientId);
+  void flushClient(int clientId);
+  void processBuffered(int clientId);
+
+  std::shared_ptr<Board> findBoard(const std::string& name);
+
+  std::string socketPath_;
+  int listenFd_;
+  int wakePipe_[2]; // los hilos avisan al bucle de que hay respuestas en finished_
+  bool stop_;
+
+  // respuestas de los hilos del grupo que el bucle principal aún no ha recogido
+  std::mutex finishedMutex_;
+  std::vector<std::pair<int, std::string>> finished_;
+
+  std::map<int, Client> clients_;
+  int nextClient_;
+
+  std::mutex boardsMutex_;
+  std::map<std::string, std::shared_ptr<Board>> boards_;
+
+  // grupo de hilos
+  std::mutex poolMutex_;
+  std::condition_variable poolWake_;
+  std::deque<std::function<void()>> tasks_;
+  bool poolStop_;
+  std::vector<std::thread> workers_;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include "bitboard.h"
+
+// Generador contador SplitMix64: el valor número counter de la secuencia de
+// seed, sin estado, de modo que cualquier hilo puede calcular cualquier valor
+std::uint64_t splitmix64(std::uint64_t seed, std::uint64_t counter);
+
+// Rellenar con una sopa aleatoria el rectángulo [rowBegin, rowEnd) x [colBegin, colEnd)
+// del tablero; el resto no se toca. Cada célula está viva con probabilidad density
+// (con una resolución de 1/65536). Las filas se reparten entre threads hilos
+// (0 = uno por núcleo) y el resultado solo depende de seed, no del número de hilos.
+void randomSoup(Bitboard& board, std::uint64_t seed, double density,
+                int rowBegin, int colBegin, int rowEnd, int colEnd, int threads = 0);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bitboard.h"
+
+// Lector del formato de texto de los tableros (el de saveToFile): una línea con
+// filas y columnas y después una línea por fila, 'X' para las células vivas.
+//
+// El fichero se proyecta con mmap en lugar de leerse línea a línea. Varios hilos
+// se reparten el texto en trozos iguales: primero cuentan los saltos de línea de
+// su trozo para saber en qué fila empieza, y después empaquetan las filas que
+// empiezan en él, comparando 16 o 32 caracteres a la vez con 'X' (SSE2/AVX2).
+class TextBoard {
+public:
+  TextBoard(const char* filename);
+  ~TextBoard();
+
+  TextBoard(const TextBoard&) = delete;
+  TextBoard& operator=(const TextBoard&) = delete;
+
+  // false si no se pudo abrir o la cabecera no es válida; el error ya se ha mostrado
+  bool isOpen() const;
+
+  // último error (sin el prefijo "Error: "), vacío si no ha habido ninguno
+  const std::string& getError() const;
+
+  int getRows() const;
+  int getCols() const;
+
+  // Empaquetar todas las filas: la fila i va a out + i * stride y la columna j al
+  // bit j. threads = 0 elige según el tamaño del fichero y los núcleos. Devuelve
+  // false, tras mostrar la primera fila incorrecta, si alguna no tiene cols caracteres
+  bool pack(std::uint64_t* out, std::size_t stride, int threads = 0);
+
+  // Cargar el tablero entero en el interior de board, que ya debe tener las dimensiones
+  bool pack(Bitboard& board, int threads = 0);
+
+private:
+  // guardar el error y mostrarlo en std::cerr
+  void fail(const std::string& message);
+
+  const char* filename_;
+  const char* data_;
+  std::size_t size_;
+  std::size_t body_; // posición de la primera fila
+  int rows_;
+  int cols_;
+  std::string error_;
+};
+
+// Empaquetar una fila de cols caracteres: la columna j va al bit j de out.
+// Escribe (cols + 63) / 64 palabras enteras
+void packTextRow(const char* text, int cols, std::uint64_t* out);
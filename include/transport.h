@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Transportes disponibles para intercambiar halos entre procesos de una misma máquina
+enum class TransportKind {
+  socket,       // sockets de dominio Unix (socketpair)
+  sharedMemory  // buzones en memoria compartida POSIX (mmap MAP_SHARED)
+};
+
+// Convierte el nombre del transporte en su valor. Devuelve false si no es válido.
+bool parseTransport(const std::string& nombre, TransportKind& kind);
+
+// Direcciones de los enlaces de un trabajador con sus vecinos
+enum Direction { kUp = 0, kDown = 1, kLeft = 2, kRight = 3 };
+
+// Extremo de un trabajador: un enlace bidireccional por dirección.
+// post() inicia un intercambio (envía out y recibirá en in) y wait() bloquea
+// hasta que terminan todos los intercambios iniciados, de modo que entre ambas
+// llamadas el trabajador puede seguir calculando.
+class Transport {
+public:
+  virtual ~Transport() {}
+
+  virtual bool hasLink(int dir) const = 0;
+  virtual void post(int dir, const void* out, void* in, std::size_t bytes) = 0;
+  virtual void wait() = 0;
+};
+
+// Conjunto de enlaces entre los trabajadores de una rejilla procRows x procCols.
+// Se crea en el proceso coordinador antes de fork() y cada hijo toma su extremo.
+class TransportNetwork {
+public:
+  virtual ~TransportNetwork() {}
+
+  // extremo del trabajador (p, q); se llama en el proceso hijo
+  virtual std::unique_ptr<Transport> endpoint(int p, int q) = 0;
+
+  // liberar en el coordinador los recursos que ya solo usan los hijos
+  virtual void release() = 0;
+};
+
+// Crear la red. Con periodic los enlaces de los bordes dan la vuelta a la rejilla;
+// maxMessage es el tamaño máximo de un mensaje en bytes
+std::unique_ptr<TransportNetwork> makeTransportNetwork(TransportKind kind, int procRows, int procCols,
+                                                       bool periodic, std::size_t maxMessage);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include "bitboard.h"
+
+// Ventana sobre el tablero: esquina superior izquierda (en células) y zoom,
+// el lado del bloque de células que resume cada carácter
+struct Viewport {
+  int row = 0;
+  int col = 0;
+  int zoom = 1;
+};
+
+// Menor zoom con el que el tablero entero cabe en height x width caracteres
+int fitZoom(int rows, int cols, int height, int width);
+
+// Añadir a out como mucho height líneas de width caracteres, cada una terminada
+// en lineEnd. Con zoom 1 se usan 'X' y '-' como en operator<<; con más zoom cada
+// carácter es un glifo de densidad del bloque. Las cuentas salen de las palabras
+// empaquetadas con popcount, así que el coste depende del tamaño de la ventana
+// y del zoom, no del tamaño del tablero
+void renderViewport(const Bitboard& board, const Viewport& view, int height, int width,
+                    std::string& out, const char* lineEnd = "\n");
@@ -1,21 +1,140 @@
 // Incluye las bibliotecas necesarias
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <limits>
 #include "lattice.h"
 #include "cell.h"
+#include "distributed.h"
+#include "pattern.h"
+#include "history.h"
+#include "interactive.h"
+#include "framestream.h"
+#include "engine.h"
+#include "rule.h"
+#include "server.h"
+#include "outofcore.h"
+#include "cellstats.h"
+#include <memory>
+#include <vector>
+#include <unistd.h>
 
 // Función para imprimir el uso del programa
 void printUsage() {
-  std::cout << "Uso: programa -size <M> <N> [-init <file>] -border <b>\n"
+  std::cout << "Uso: programa -size <M> <N> [-init <file>] -border <b> [-procs <P> <Q> [-transport <t>]]\n"
             << "Donde:\n"
             << "  <M>: Número de filas\n"
             << "  <N>: Número de columnas\n"
             << "  <file>: Nombre del archivo con los valores iniciales\n"
-            << "  <b>: Tipo de borde (periodic, noBorder, abiertaFria o abiertaCaliente)\n";
+            << "  <b>: Tipo de borde (periodic, noBorder, abiertaFria o abiertaCaliente)\n"
+            << "  <P> <Q>: Rejilla de procesos del modo distribuido (requiere -init)\n"
+            << "  <t>: Transporte entre procesos (socket o shm, por defecto socket)\n"
+            << "Opciones de sopa aleatoria: -random <seed> <density> [-region <r0> <c0> <r1> <c1>]\n"
+            << "  <seed>: Semilla; la misma semilla da siempre el mismo tablero\n"
+            << "  <density>: Probabilidad de que una célula esté viva (0 a 1)\n"
+            << "  <r0> <c0> <r1> <c1>: Rectángulo [r0, r1) x [c0, c1) a rellenar (por defecto todo)\n"
+            << "Estampar patrones (repetible): -stamp <patron> <fila> <columna> <gen> <modo>\n"
+            << "  <patron>: glider, lwss, blinker, block, rpentomino, gosperGun o un fichero\n"
+            << "  <gen>: Generación en la que se estampa (0 = al inicio)\n"
+            << "  <modo>: or, xor o set\n"
+            << "Historial: -history <file> <K> guarda cada generación (un fotograma completo cada K)\n"
+            << "           -replay <file> <gen> empieza desde la generación <gen> de un historial\n"
+            << "Fotogramas: -frames <file> <N> pbm | -frames <file> <N> pgm <zoom>\n"
+            << "  Escribe una de cada <N> generaciones como imagen binaria (pbm: una célula por\n"
+            << "  píxel; pgm: densidad de bloques <zoom> x <zoom>) en un fichero o tubería\n"
+            << "Núcleo de cálculo: -engine <e> [-rule <regla>] [-adapt <N>]\n"
+            << "  <e>: scalar (por defecto), bitsliced, lut (tabla de bloques 2x2, admite cualquier\n"
+            << "       regla), tiled (solo las baldosas activas) o auto (elige según el tablero)\n"
+            << "  <regla>: notación B/S, por defecto B3/S23\n"
+            << "  <N>: con auto, generaciones entre dos mediciones (por defecto 32)\n"
+            << "Servidor: -serve <socket> [<hilos>] atiende órdenes (load, step, population, bbox,\n"
+            << "  snapshot, stamp...) sobre tableros con nombre en un socket de dominio Unix\n"
+            << "Fuera de memoria: -outofcore <packed> [<filas>] calcula por franjas de <filas> filas\n"
+            << "  sobre un fichero empaquetado proyectado con mmap; con -init se crea a partir del texto\n"
+            << "Estadísticas: -stats <prefix> <pgm|bin> guarda al salir la edad de cada célula y\n"
+            << "  la actividad por baldosas de 64x64 en <prefix>-age y <prefix>-activity\n"
+            << "Modo interactivo (si la entrada es un terminal): -rate <gps> generaciones por segundo\n"
+            << "  (0 = sin límite, por defecto 10). Con la entrada redirigida se usa el menú por líneas\n";
+}
+
+// Patrón pedido con -stamp
+struct StampRequest {
+  Bitboard pattern;
+  int row;
+  int col;
+  std::size_t generation;
+  StampMode mode;
+};
+
+// Guardar las estadísticas de -stats como <prefix>-age y <prefix>-activity
+void writeStats(const CellStats& stats, const std::string& prefix, bool binary) {
+  if (binary)
+  {
+    stats.writeAgeBinary((prefix + "-age.bin").c_str());
+    stats.writeActivityBinary((prefix + "-activity.bin").c_str());
+  } else
+  {
+    stats.writeAgePgm((prefix + "-age.pgm").c_str());
+    stats.writeActivityPgm((prefix + "-activity.pgm").c_str());
+  }
+}
+
+// Los modos distribuido y fuera de memoria no tienen un Lattice: las opciones
+// que solo entiende el retículo en memoria se rechazan en lugar de ignorarlas
+bool rejectLatticeOptions(const std::string& mode, const std::vector<std::string>& options) {
+  if (options.empty())
+  {
+    return false;
+  }
+  std::cerr << "Error: El modo " << mode << " no admite";
+  for (const std::string& option : options)
+  {
+    std::cerr << " " << option;
+  }
+  std::cerr << ".\n";
+  printUsage();
+  return true;
+}
+
+// Menú de los modos distribuido y fuera de memoria: siempre en modo población,
+// el tablero no se imprime
+template <typename BigLattice>
+int runPopulationMenu(BigLattice& lattice) {
+  char stopChar;
+  std::string targetFile;
+  std::cout << "Retículo de " << lattice.getRows() << "x" << lattice.getCols() << ". "
+            << "Número de células vivas: " << lattice.Population() << std::endl << std::endl;
+  do
+  {
+    std::cout << "Presiona 'x' para salir, o cualquiera de estas otras teclas para seleccionar opción: " << std::endl;
+    std::cout << "'n' - Siguiente generación" << std::endl;
+    std::cout << "'L' - Siguientes cinco generaciones" << std::endl;
+    std::cout << "'s' - Guarde el tablero actual a un fichero" << std::endl;
+    std::cin >> stopChar;
+    std::cout << std::endl;
+
+    if (stopChar == 'n' || stopChar == 'L')
+    {
+      lattice.nextGeneration(stopChar == 'n' ? 1 : 5);
+      std::cout << "Número de células vivas: " << lattice.Population() << std::endl << std::endl;
+    } else if (stopChar == 's')
+    {
+      std::cout << "Escriba el nombre del archivo de salida:" << std::endl;
+      std::cin >> targetFile;
+      lattice.saveToFile(targetFile.c_str());
+    } else if (stopChar != 'x')
+    {
+      std::cout << "Ingrese una opción válida: " << std::endl;
+    }
+  } while (stopChar != 'x' && std::cin);
+
+  return 0;
 }
 
 int main(int argc, char *argv[]) {
-  if (argc < 5 || argc > 6) { // Verificar el número de argumentos
+  // El servidor no necesita tablero inicial
+  const bool serving = argc >= 3 && std::string(argv[1]) == "-serve";
+  if (argc < 5 && !serving) { // Verificar el número de argumentos
     std::cerr << "Número incorrecto de argumentos.\n";
     printUsage();
     return 1;
@@ -24,18 +143,67 @@ int main(int argc, char *argv[]) {
   std::string sizeFlag = "-size";
   std::string initFlag = "-init";
   std::string borderFlag = "-border";
+  std::string procsFlag = "-procs";
+  std::string transportFlag = "-transport";
+  std::string randomFlag = "-random";
+  std::string regionFlag = "-region";
+  std::string stampFlag = "-stamp";
+  std::string historyFlag = "-history";
+  std::string replayFlag = "-replay";
+  std::string rateFlag = "-rate";
+  std::string framesFlag = "-frames";
+  std::string engineFlag = "-engine";
+  std::string ruleFlag = "-rule";
+  std::string adaptFlag = "-adapt";
+  std::string serveFlag = "-serve";
+  std::string outOfCoreFlag = "-outofcore";
+  std::string statsFlag = "-stats";
   std::string sizeFile;
   std::string initFile;
   std::string borderType;
+  Frontera frontera = Frontera::abiertaFria;
 
   bool hasSizeFlag = false;
   bool hasBorderFlag = false;
+  int procRows = 0;
+  int procCols = 0;
+  TransportKind transport = TransportKind::socket;
+  bool hasRandomFlag = false;
+  std::uint64_t seed = 0;
+  double density = 0.0;
+  int region[4] = {0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+  std::vector<StampRequest> stamps;
+  std::string historyFile;
+  int keyframeInterval = 0;
+  std::string replayFile;
+  std::size_t replayGeneration = 0;
+  double rate = 10.0;
+  std::string framesFile;
+  int framesEvery = 1;
+  FrameFormat framesFormat = FrameFormat::pbm;
+  int framesZoom = 1;
+  EngineKind engine = EngineKind::scalar;
+  int adaptInterval = 32;
+  Rule rule;
+  std::string socketPath;
+  int serverThreads = 0;
+  std::string packedFile;
+  int bandRows = 0;
+  std::string statsPrefix;
+  bool statsBinary = false;
+  // opciones dadas que solo admite el retículo en memoria
+  std::vector<std::string> latticeOptions;
 
   Lattice lattice(1);
 
   // Parsear los argumentos de la línea de comandos
   for (int i = 1; i < argc; ++i) {
     std::string arg = argv[i];
+    if ((arg == randomFlag || arg == stampFlag || arg == historyFlag || arg == replayFlag || arg == rateFlag ||
+         arg == framesFlag || arg == engineFlag || arg == ruleFlag || arg == adaptFlag || arg == statsFlag) &&
+        std::find(latticeOptions.begin(), latticeOptions.end(), arg) == latticeOptions.end()) {
+      latticeOptions.push_back(arg);
+    }
     if (arg == sizeFlag) {
       // Verificar que no se haya utilizado previamente el flag -size
       if (hasSizeFlag) {
@@ -81,7 +249,7 @@ int main(int argc, char *argv[]) {
       // Obtener el tipo de borde
       if (i + 1 < argc) {
         borderType = argv[i + 1];
-        if (borderType != "periodic" && borderType != "noBorder" && borderType != "abiertaFria" && borderType != "abiertaCaliente") // Utiliza && en lugar de ||
+        if (!parseFrontera(borderType, frontera)) // El tipo de borde se interpreta una sola vez
         {
           std::cerr << "Error: Tipo de borde no válido.\n";
           printUsage();
@@ -94,6 +262,178 @@ int main(int argc, char *argv[]) {
         printUsage();
         return 1;
       }
+    } else if (arg == procsFlag) {
+      // Obtener la rejilla de procesos
+      if (i + 2 < argc) {
+        procRows = std::stoi(argv[i + 1]);
+        procCols = std::stoi(argv[i + 2]);
+        i += 2;
+      } else {
+        std::cerr << "Error: Se esperaban dos argumentos después de -procs.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == transportFlag) {
+      if (i + 1 < argc && parseTransport(argv[i + 1], transport)) {
+        ++i;
+      } else {
+        std::cerr << "Error: Transporte no válido.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == randomFlag) {
+      // Obtener la semilla y la densidad de la sopa
+      if (i + 2 < argc) {
+        seed = std::stoull(argv[i + 1]);
+        density = std::stod(argv[i + 2]);
+        i += 2;
+        hasRandomFlag = true;
+      } else {
+        std::cerr << "Error: Se esperaban dos argumentos después de -random.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == regionFlag) {
+      if (i + 4 < argc) {
+        for (int k = 0; k < 4; ++k) {
+          region[k] = std::stoi(argv[i + 1 + k]);
+        }
+        i += 4;
+      } else {
+        std::cerr << "Error: Se esperaban cuatro argumentos después de -region.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == stampFlag) {
+      // Obtener el patrón, su posición, la generación y el modo
+      StampRequest request;
+      if (i + 5 < argc && findPattern(argv[i + 1], request.pattern) && parseStampMode(argv[i + 5], request.mode)) {
+        request.row = std::stoi(argv[i + 2]);
+        request.col = std::stoi(argv[i + 3]);
+        request.generation = std::stoul(argv[i + 4]);
+        stamps.push_back(request);
+        i += 5;
+      } else {
+        std::cerr << "Error: Se esperaba -stamp <patron> <fila> <columna> <gen> <modo>.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == historyFlag) {
+      // Obtener el fichero de historial y el intervalo de fotogramas completos
+      if (i + 2 < argc) {
+        historyFile = argv[i + 1];
+        keyframeInterval = std::stoi(argv[i + 2]);
+        i += 2;
+      } else {
+        std::cerr << "Error: Se esperaban dos argumentos después de -history.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == replayFlag) {
+      if (hasSizeFlag) {
+        std::cerr << "Error: El flag -size ya ha sido especificado.\n";
+        printUsage();
+        return 1;
+      }
+      // Obtener el historial y la generación de partida
+      if (i + 2 < argc) {
+        replayFile = argv[i + 1];
+        replayGeneration = std::stoul(argv[i + 2]);
+        i += 2;
+      } else {
+        std::cerr << "Error: Se esperaban dos argumentos después de -replay.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == rateFlag) {
+      if (i + 1 < argc) {
+        rate = std::stod(argv[i + 1]);
+        ++i;
+      } else {
+        std::cerr << "Error: Se esperaba un argumento después de -rate.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == framesFlag) {
+      // Obtener el destino, la frecuencia y el formato (pgm lleva además el zoom)
+      if (i + 3 < argc && parseFrameFormat(argv[i + 3], framesFormat) &&
+          (framesFormat == FrameFormat::pbm || i + 4 < argc)) {
+        framesFile = argv[i + 1];
+        framesEvery = std::stoi(argv[i + 2]);
+        i += 3;
+        if (framesFormat == FrameFormat::pgm) {
+          framesZoom = std::stoi(argv[i + 1]);
+          ++i;
+        }
+      } else {
+        std::cerr << "Error: Se esperaba -frames <file> <N> pbm o -frames <file> <N> pgm <zoom>.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == engineFlag) {
+      if (i + 1 < argc && parseEngine(argv[i + 1], engine)) {
+        ++i;
+      } else {
+        std::cerr << "Error: Núcleo no válido.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == adaptFlag) {
+      if (i + 1 < argc) {
+        adaptInterval = std::stoi(argv[i + 1]);
+        ++i;
+      } else {
+        std::cerr << "Error: Se esperaba un argumento después de -adapt.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == ruleFlag) {
+      if (i + 1 < argc && parseRule(argv[i + 1], rule)) {
+        ++i;
+      } else {
+        std::cerr << "Error: Regla no válida.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == outOfCoreFlag) {
+      // Obtener el fichero empaquetado y, si se indica, las filas por franja
+      if (i + 1 < argc) {
+        packedFile = argv[i + 1];
+        ++i;
+        if (i + 1 < argc && argv[i + 1][0] != '-') {
+          bandRows = std::stoi(argv[i + 1]);
+          ++i;
+        }
+      } else {
+        std::cerr << "Error: Se esperaba un argumento después de -outofcore.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == statsFlag) {
+      // Obtener el prefijo de los ficheros y el formato
+      if (i + 2 < argc && (std::string(argv[i + 2]) == "pgm" || std::string(argv[i + 2]) == "bin")) {
+        statsPrefix = argv[i + 1];
+        statsBinary = std::string(argv[i + 2]) == "bin";
+        i += 2;
+      } else {
+        std::cerr << "Error: Se esperaba -stats <prefix> <pgm|bin>.\n";
+        printUsage();
+        return 1;
+      }
+    } else if (arg == serveFlag) {
+      // Obtener la ruta del socket y, si se indica, el número de hilos
+      if (i + 1 < argc) {
+        socketPath = argv[i + 1];
+        ++i;
+        if (i + 1 < argc && argv[i + 1][0] != '-') {
+          serverThreads = std::stoi(argv[i + 1]);
+          ++i;
+        }
+      } else {
+        std::cerr << "Error: Se esperaba un argumento después de -serve.\n";
+        printUsage();
+        return 1;
+      }
     } else {
       std::cerr << "Error: Argumento desconocido '" << arg << "'.\n";
       printUsage();
@@ -101,17 +441,157 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  if (hasSizeFlag)
+  if (!socketPath.empty())
+  {
+    SimulationServer server(socketPath.c_str(), serverThreads);
+    return server.run();
+  }
+
+  if (!rule.isConway() && engine != EngineKind::lut && engine != EngineKind::adaptive)
+  {
+    std::cerr << "Error: La regla " << ruleToString(rule) << " requiere -engine lut o auto.\n";
+    printUsage();
+    return 1;
+  }
+
+  if (procRows > 0 || procCols > 0)
+  {
+    // Modo distribuido: el tablero nunca se carga entero en este proceso
+    if (hasSizeFlag || frontera == Frontera::noBorder) {
+      std::cerr << "Error: El modo distribuido requiere -init y una frontera de tamaño fijo.\n";
+      printUsage();
+      return 1;
+    }
+    if (rejectLatticeOptions("distribuido", latticeOptions)) {
+      return 1;
+    }
+    DistributedLattice distributed(initFile.c_str(), procRows, procCols, frontera, transport);
+    if (!distributed.isReady()) {
+      return 1;
+    }
+    return runPopulationMenu(distributed);
+  }
+
+  if (!packedFile.empty())
+  {
+    // Modo fuera de memoria: el tablero solo está en el fichero empaquetado
+    if (hasSizeFlag) {
+      std::cerr << "Error: El modo fuera de memoria requiere -init o un fichero empaquetado ya creado.\n";
+      printUsage();
+      return 1;
+    }
+    if (rejectLatticeOptions("fuera de memoria", latticeOptions)) {
+      return 1;
+    }
+    if (!initFile.empty() && !OutOfCoreLattice::convertText(initFile.c_str(), packedFile.c_str())) {
+      return 1;
+    }
+    OutOfCoreLattice outOfCore(packedFile.c_str(), frontera, bandRows);
+    if (!outOfCore.isReady()) {
+      return 1;
+    }
+    return runPopulationMenu(outOfCore);
+  }
+
+  if (!replayFile.empty())
+  {
+    // Reconstruir la generación pedida del historial
+    HistoryReader reader(replayFile.c_str());
+    Bitboard board;
+    if (!reader.isOpen() || !reader.seek(replayGeneration, board))
+    {
+      std::cerr << "Error: La generación " << replayGeneration << " no está en el historial (hay de la "
+                << reader.firstGeneration() << " a la " << reader.lastGeneration() << ").\n";
+      return 1;
+    }
+    Lattice lattice2(board, replayGeneration);
+    lattice = lattice2;
+  } else if (hasSizeFlag && hasRandomFlag)
+  {
+    // Tablero vacío sin preguntar por teclado; la sopa se siembra después
+    Lattice lattice2(std::stoi(sizeFile), std::stoi(initFile), seed, 0.0);
+    lattice = lattice2;
+  } else if (hasSizeFlag)
   {
     Lattice lattice2(std::stoi(sizeFile), std::stoi(initFile));
     lattice = lattice2;
   } else
   {
     Lattice lattice2(initFile.c_str());
+    if (!lattice2.getLoadError().empty())
+    {
+      // el motivo ya se ha mostrado al leer el fichero
+      return 1;
+    }
     lattice = lattice2;
   }
   
-  lattice.setFrontera(borderType);
+  if (hasRandomFlag)
+  {
+    lattice.randomSoup(seed, density, region[0], region[1], region[2], region[3]);
+  }
+
+  // Los patrones de la generación 0 se estampan ya; el resto queda en cola
+  for (const StampRequest& request : stamps)
+  {
+    if (request.generation == 0)
+    {
+      lattice.stamp(request.pattern, request.row, request.col, request.mode);
+    } else
+    {
+      lattice.queueStamp(request.generation, request.pattern, request.row, request.col, request.mode);
+    }
+  }
+
+  lattice.setFrontera(frontera);
+  lattice.setEngine(engine, rule, adaptInterval);
+
+  // El historial empieza por el estado inicial y se cierra al salir
+  std::unique_ptr<HistoryWriter> history;
+  if (!historyFile.empty())
+  {
+    history.reset(new HistoryWriter(historyFile.c_str(), keyframeInterval));
+    if (!history->isOpen())
+    {
+      return 1;
+    }
+    history->append(lattice.getGeneration(), lattice.getBoard());
+    lattice.setHistory(history.get());
+  }
+
+  std::unique_ptr<FrameStream> frames;
+  if (!framesFile.empty())
+  {
+    frames.reset(new FrameStream(framesFile.c_str(), framesFormat, framesEvery, framesZoom));
+    if (!frames->isOpen())
+    {
+      return 1;
+    }
+    frames->write(lattice.getGeneration(), lattice.getBoard());
+    lattice.setFrameStream(frames.get());
+  }
+
+  // Las estadísticas solo existen si se piden; sin ellas el núcleo no las toca
+  std::unique_ptr<CellStats> stats;
+  if (!statsPrefix.empty())
+  {
+    stats.reset(new CellStats(lattice.getBoard()));
+    lattice.setStats(stats.get());
+  }
+
+  // En un terminal, el simulador corre en segundo plano y las teclas no esperan
+  // a la generación; con la entrada redirigida se conserva el menú por líneas
+  if (isatty(STDIN_FILENO) && isatty(STDOUT_FILENO))
+  {
+    InteractiveSession session(lattice, rate);
+    const int status = session.run();
+    if (stats)
+    {
+      writeStats(*stats, statsPrefix, statsBinary);
+    }
+    return status;
+  }
+
   char stopChar;
   std::string targetFile;
   std::cout << lattice << std:: endl;
@@ -162,6 +642,10 @@ int main(int argc, char *argv[]) {
     }
   } while (stopChar != 'x');
   
+  if (stats)
+  {
+    writeStats(*stats, statsPrefix, statsBinary);
+  }
 
   return 0;
 }
@@ -0,0 +1,275 @@
+#include "bitboard.h"
+#include <algorithm>
+
+Bitboard::Bitboard() : rows_(0), cols_(0), words_(0), stride_(2) {
+  bits_.assign(2 * stride_, 0);
+}
+
+Bitboard::Bitboard(int rows, int cols) {
+  rows_ = rows;
+  cols_ = cols;
+  words_ = (cols + 63) / 64;
+  stride_ = words_ + 2;
+  // filas del interior más las dos del halo
+  bits_.assign(static_cast<std::size_t>(rows + 2) * stride_, 0);
+}
+
+int Bitboard::getRows() const {
+  return rows_;
+}
+
+int Bitboard::getCols() const {
+  return cols_;
+}
+
+int Bitboard::getWords() const {
+  return words_;
+}
+
+int Bitboard::getStride() const {
+  return stride_;
+}
+
+void Bitboard::clear() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+// Combina n bits de src (empezando en srcBit) con dst (empezando en dstBit)
+// según el modo, hasta 64 bits por iteración
+static void blitBits(std::uint64_t* dst, std::size_t dstBit, const std::uint64_t* src, std::size_t srcBit,
+                     std::size_t n, StampMode mode) {
+  while (n > 0) {
+    const std::size_t dstShift = dstBit & 63;
+    const std::size_t chunk = std::min<std::size_t>(n, 64 - dstShift);
+    const std::size_t srcWord = srcBit >> 6;
+    const std::size_t srcShift = srcBit & 63;
+    std::uint64_t value = src[srcWord] >> srcShift;
+    if (srcShift != 0 && srcShift + chunk > 64) {
+      value |= src[srcWord + 1] << (64 - srcShift);
+    }
+    const std::uint64_t mask = (chunk == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << chunk) - 1) << dstShift;
+    value = (value << dstShift) & mask;
+    std::uint64_t& out = dst[dstBit >> 6];
+    switch (mode) {
+      case StampMode::overwrite:
+        out = (out & ~mask) | value;
+        break;
+      case StampMode::bitOr:
+        out |= value;
+        break;
+      case StampMode::bitXor:
+        out ^= value;
+        break;
+    }
+    dstBit += chunk;
+    srcBit += chunk;
+    n -= chunk;
+  }
+}
+
+void Bitboard::grow(int top, int left, int bottom, int right) {
+  Bitboard bigger(rows_ + top + bottom, cols_ + left + right);
+  for (int i = 0; i < rows_; ++i) {
+    blitBits(bigger.row(i + top), 64 + left, row(i), 64, cols_, StampMode::overwrite);
+  }
+  swap(bigger);
+}
+
+void Bitboard::stamp(const Bitboard& pattern, int row, int col, StampMode mode) {
+  // parte del patrón que cae dentro del interior
+  const int firstRow = std::max(0, -row);
+  const int lastRow = std::min(pattern.getRows(), rows_ - row);
+  const int firstCol = std::max(0, -col);
+  const int lastCol = std::min(pattern.getCols(), cols_ - col);
+  if (firstRow >= lastRow || firstCol >= lastCol) {
+    return;
+  }
+  for (int i = firstRow; i < lastRow; ++i) {
+    blitBits(this->row(row + i), 64 + col + firstCol, pattern.row(i), 64 + firstCol, lastCol - firstCol, mode);
+  }
+}
+
+void Bitboard::fillRect(int rowBegin, int colBegin, int rowEnd, int colEnd, bool state) {
+  rowBegin = std::max(rowBegin, 0);
+  colBegin = std::max(colBegin, 0);
+  rowEnd = std::min(rowEnd, rows_);
+  colEnd = std::min(colEnd, cols_);
+  if (rowBegin >= rowEnd || colBegin >= colEnd) {
+    return;
+  }
+  // palabras del rango de bits [colBegin + 64, colEnd + 64)
+  const int firstWord = (colBegin + 64) >> 6;
+  const int lastWord = (colEnd + 63) >> 6;
+  const std::uint64_t firstMask = ~std::uint64_t(0) << (colBegin & 63);
+  const std::uint64_t lastMask = ((colEnd & 63) == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << (colEnd & 63)) - 1;
+  for (int i = rowBegin; i < rowEnd; ++i) {
+    std::uint64_t* r = row(i);
+    for (int k = firstWord; k <= lastWord; ++k) {
+      std::uint64_t mask = ~std::uint64_t(0);
+      if (k == firstWord) {
+        mask &= firstMask;
+      }
+      if (k == lastWord) {
+        mask &= lastMask;
+      }
+      r[k] = state ? (r[k] | mask) : (r[k] & ~mask);
+    }
+  }
+}
+
+std::uint64_t Bitboard::lastWordMask() const {
+  const int valid = cols_ - 64 * (words_ - 1);
+  return valid == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << valid) - 1;
+}
+
+std::size_t Bitboard::population() const {
+  std::size_t aliveCount = 0;
+  const std::uint64_t mask = lastWordMask();
+  for (int i = 0; i < rows_; ++i) {
+    const std::uint64_t* r = row(i);
+    for (int k = 1; k < words_; ++k) {
+      aliveCount += __builtin_popcountll(r[k]);
+    }
+    aliveCount += __builtin_popcountll(r[words_] & mask);
+  }
+  return aliveCount;
+}
+
+// Filas vacías fuera de la caja; las columnas salen del OR de las filas ocupadas,
+// con ctz/clz por palabra
+bool Bitboard::boundingBox(int& rowBegin, int& colBegin, int& rowEnd, int& colEnd) const {
+  const std::uint64_t mask = lastWordMask();
+  std::vector<std::uint64_t> occupied(words_, 0);
+  int first = -1;
+  int last = -1;
+  for (int i = 0; i < rows_; ++i) {
+    const std::uint64_t* r = row(i);
+    std::uint64_t any = 0;
+    for (int k = 1; k <= words_; ++k) {
+      const std::uint64_t word = k == words_ ? r[k] & mask : r[k];
+      occupied[k - 1] |= word;
+      any |= word;
+    }
+    if (any != 0) {
+      if (first < 0) {
+        first = i;
+      }
+      last = i;
+    }
+  }
+  if (first < 0) {
+    return false;
+  }
+  int k = 0;
+  while (occupied[k] == 0) {
+    ++k;
+  }
+  colBegin = k * 64 + __builtin_ctzll(occupied[k]);
+  k = words_ - 1;
+  while (occupied[k] == 0) {
+    --k;
+  }
+  colEnd = k * 64 + 64 - __builtin_clzll(occupied[k]);
+  rowBegin = first;
+  rowEnd = last + 1;
+  return true;
+}
+
+// Halo según la frontera:
+//  - periodic: las columnas -1 y cols copian la última y la primera columna de
+//    cada fila, y las filas -1 y rows son copias completas (esquinas incluidas)
+//    de la última y la primera fila ya con sus columnas de halo
+//  - abiertaCaliente: todo el halo vivo
+//  - abiertaFria y noBorder: todo el halo muerto; en noBorder Lattice hace
+//    crecer el tablero en cuanto una célula viva llega al borde, así el halo
+//    muerto no cambia el resultado
+// Las filas del halo se rellenan palabra a palabra y las columnas bit a bit
+void Bitboard::fillHalo(Frontera frontera) {
+  if (rows_ == 0 || cols_ == 0) {
+    return;
+  }
+  if (frontera == Frontera::periodic) {
+    for (int i = 0; i < rows_; ++i) {
+      set(i, -1, get(i, cols_ - 1));
+      set(i, cols_, get(i, 0));
+    }
+    // las filas del halo son copias exactas de las filas opuestas, esquinas incluidas
+    std::copy(row(rows_ - 1), row(rows_ - 1) + stride_, row(-1));
+    std::copy(row(0), row(0) + stride_, row(rows_));
+  } else {
+    const bool temp = (frontera == Frontera::abiertaCaliente);
+    const std::uint64_t fill = temp ? ~std::uint64_t(0) : 0;
+    std::fill(row(-1), row(-1) + stride_, fill);
+    std::fill(row(rows_), row(rows_) + stride_, fill);
+    for (int i = 0; i < rows_; ++i) {
+      set(i, -1, temp);
+      set(i, cols_, temp);
+    }
+  }
+}
+
+// Sumadores de un bit aplicados a 64 células a la vez
+static inline void halfAdder(std::uint64_t a, std::uint64_t b, std::uint64_t& sum, std::uint64_t& carry) {
+  sum = a ^ b;
+  carry = a & b;
+}
+
+static inline void fullAdder(std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t& sum, std::uint64_t& carry) {
+  const std::uint64_t u = a ^ b;
+  sum = u ^ c;
+  carry = (a & b) | (u & c);
+}
+
+void Bitboard::step(Bitboard& next) const {
+  stepRegion(next, 0, rows_, 1, words_ + 1);
+}
+
+// Núcleo sin ramas: cuenta los ocho vecinos de 64 células con un árbol de
+// sumadores y aplica la regla B3/S23 sobre los bits del contador
+void Bitboard::stepRegion(Bitboard& next, int rowBegin, int rowEnd, int wordBegin, int wordEnd) const {
+  const std::uint64_t mask = lastWordMask();
+  for (int i = rowBegin; i < rowEnd; ++i) {
+    const std::uint64_t* up = row(i - 1);
+    const std::uint64_t* mid = row(i);
+    const std::uint64_t* down = row(i + 1);
+    std::uint64_t* out = next.row(i);
+    for (int k = wordBegin; k < wordEnd; ++k) {
+      // vecinos izquierdo (columna - 1) y derecho (columna + 1) de cada fila
+      const std::uint64_t upW = (up[k] << 1) | (up[k - 1] >> 63);
+      const std::uint64_t upE = (up[k] >> 1) | (up[k + 1] << 63);
+      const std::uint64_t midW = (mid[k] << 1) | (mid[k - 1] >> 63);
+      const std::uint64_t midE = (mid[k] >> 1) | (mid[k + 1] << 63);
+      const std::uint64_t downW = (down[k] << 1) | (down[k - 1] >> 63);
+      const std::uint64_t downE = (down[k] >> 1) | (down[k + 1] << 63);
+
+      std::uint64_t s0, c0, s1, c1, s2, c2;
+      fullAdder(upW, up[k], upE, s0, c0);
+      fullAdder(midW, midE, downW, s1, c1);
+      halfAdder(down[k], downE, s2, c2);
+
+      // bit de peso 1 y acarreos de peso 2
+      std::uint64_t bit0, k1;
+      fullAdder(s0, s1, s2, bit0, k1);
+      // bits de peso 2 y 4 (el de peso 8 solo importa para descartar)
+      std::uint64_t t0, t1, bit1, t2;
+      fullAdder(c0, c1, c2, t0, t1);
+      halfAdder(t0, k1, bit1, t2);
+      const std::uint64_t high = t1 | t2;
+
+      // viva con 2 o 3 vecinos, o muerta con 3
+      out[k] = bit1 & ~high & (bit0 | mid[k]);
+    }
+    // las columnas que sobran en la última palabra quedan siempre muertas
+    if (wordBegin <= words_ && words_ < wordEnd) {
+      out[words_] &= mask;
+    }
+  }
+}
+
+void Bitboard::swap(Bitboard& other) {
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(words_, other.words_);
+  std::swap(stride_, other.stride_);
+  bits_.swap(other.bits_);
+}
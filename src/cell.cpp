@@ -36,106 +36,22 @@ void Cell::setPosition(int row, int col) {
   position_.second = col;
 }
 
-// Vecindad
+// Vecindad. Gracias al halo del retículo toda célula tiene siempre ocho vecinos,
+// así que se leen sin comprobar los límites
 std::vector<Cell> Cell::getNeighbors(Lattice& lattice) {
-  
-  lattice.updatePositions();
   std::vector<Cell> neighbors;
   Position pos(this->getPosition());
 
-  if (lattice.getFrontera() != "noBorder")
-  {
-    // Conocer los estados de su vecindad, en sentido horario empezando por la izquierda
-    neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-    neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second - 1)]); // arriba izquierda
-    neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-    neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second + 1)]); // arriba derecha
-    neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-    neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second + 1)]); // abajo derecha
-    neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-    neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second - 1)]); // abajo izquierda
-  } else
-  {
-    if (pos.first == 0 && pos.second == 0) // Esquina superior izq
-    {
-
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second + 1)]); // abajo derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-
-    } else if (pos.first == 0 && pos.second == lattice.getCols() - 1) // Esquina superior derecha
-    {
-
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second - 1)]); // abajo izquierda
-
-    } else if (pos.first == lattice.getRows() - 1 && pos.second == lattice.getCols() - 1) // Esquina inferior derecha
-    {
-      
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second - 1)]); // arriba izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-
-    } else if (pos.first == lattice.getRows() - 1 && pos.second == 0) // Esquina inferior izquierda
-    {
-      
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second + 1)]); // arriba derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-
-    } else if (pos.first == 0) // Borde superior
-    {
-
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second + 1)]); // abajo derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second - 1)]); // abajo izquierda
-
-    } else if (pos.second == lattice.getCols() - 1) // Borde derecho
-    {
-      
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second - 1)]); // abajo izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second - 1)]); // arriba izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-
-    } else if (pos.first == lattice.getRows() - 1) // Borde inferior
-    {
-
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second - 1)]); // arriba izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second + 1)]); // arriba derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-
-    } else if (pos.second == 0) // Borde izquierdo
-    {
-      
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second + 1)]); // arriba derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second + 1)]); // abajo derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-
-    } else
-    {
-      // Conocer los estados de su vecindad, en sentido horario empezando por la izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second - 1)]); // izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second - 1)]); // arriba izquierda
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second)]); // arriba
-      neighbors.push_back(lattice[std::make_pair(pos.first - 1, pos.second + 1)]); // arriba derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first, pos.second + 1)]); // derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second + 1)]); // abajo derecha
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second)]); // abajo
-      neighbors.push_back(lattice[std::make_pair(pos.first + 1, pos.second - 1)]); // abajo izquierda
-    }
-  }
-  
-  
-  
+  // Conocer los estados de su vecindad, en sentido horario empezando por la izquierda
+  neighbors.push_back(Cell(std::make_pair(pos.first, pos.second - 1), lattice.at_unchecked(pos.first, pos.second - 1))); // izquierda
+  neighbors.push_back(Cell(std::make_pair(pos.first - 1, pos.second - 1), lattice.at_unchecked(pos.first - 1, pos.second - 1))); // arriba izquierda
+  neighbors.push_back(Cell(std::make_pair(pos.first - 1, pos.second), lattice.at_unchecked(pos.first - 1, pos.second))); // arriba
+  neighbors.push_back(Cell(std::make_pair(pos.first - 1, pos.second + 1), lattice.at_unchecked(pos.first - 1, pos.second + 1))); // arriba derecha
+  neighbors.push_back(Cell(std::make_pair(pos.first, pos.second + 1), lattice.at_unchecked(pos.first, pos.second + 1))); // derecha
+  neighbors.push_back(Cell(std::make_pair(pos.first + 1, pos.second + 1), lattice.at_unchecked(pos.first + 1, pos.second + 1))); // abajo derecha
+  neighbors.push_back(Cell(std::make_pair(pos.first + 1, pos.second), lattice.at_unchecked(pos.first + 1, pos.second))); // abajo
+  neighbors.push_back(Cell(std::make_pair(pos.first + 1, pos.second - 1), lattice.at_unchecked(pos.first + 1, pos.second - 1))); // abajo izquierda
+
   return neighbors;
 }
 
@@ -150,27 +66,13 @@ State Cell::transitionFunction(std::vector<Cell> neighbors) {
       aliveCount++;
     }
   }
-  
-  // Lógica de la funcion de transicion
-  if (this->getState())
-  {
-    if (aliveCount == 2 || aliveCount == 3)
-    {
-      return true;
-    } else
-    {
-      return false;
-    }
-  } else
-  {
-    if (aliveCount == 3)
-    {
-      return true;
-    } else
-    {
-      return false;
-    } 
-  }
+
+  return transitionFunction(aliveCount);
+}
+
+// Funcion de transicion a partir del número de vecinos vivos
+State Cell::transitionFunction(int aliveCount) const {
+  return transitionFunction(this->getState(), aliveCount);
 }
 
 // Implementación de la sobrecarga del operador <<
@@ -0,0 +1,182 @@
+#include "cellstats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+CellStats::CellStats(const Bitboard& board) {
+  rows_ = board.getRows();
+  cols_ = board.getCols();
+  words_ = board.getWords();
+  tileRows_ = (rows_ + kTile - 1) / kTile;
+  tileCols_ = (cols_ + kTile - 1) / kTile;
+  generations_ = 0;
+  age_.assign(static_cast<std::size_t>(rows_) * cols_, 0);
+  activity_.assign(static_cast<std::size_t>(tileRows_) * tileCols_, 0);
+  changed_.assign(activity_.size(), 0);
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < cols_; ++j) {
+      age_[static_cast<std::size_t>(i) * cols_ + j] = board.get(i, j);
+    }
+  }
+}
+
+int CellStats::getRows() const {
+  return rows_;
+}
+
+int CellStats::getCols() const {
+  return cols_;
+}
+
+std::size_t CellStats::getGenerations() const {
+  return generations_;
+}
+
+// kTile es 64: cada palabra interior es justo una columna de baldosas
+void CellStats::updateRow(int i, const std::uint64_t* oldRow, const std::uint64_t* newRow) {
+  std::uint8_t* age = age_.data() + static_cast<std::size_t>(i) * cols_;
+  std::uint8_t* changed = changed_.data() + static_cast<std::size_t>(i / kTile) * tileCols_;
+  for (int k = 0; k < words_; ++k) {
+    const std::uint64_t word = newRow[k + 1];
+    const int begin = k * 64;
+    const int end = std::min(begin + 64, cols_);
+    // las columnas de relleno de la última palabra no cuentan como cambio
+    const std::uint64_t valid = end - begin == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << (end - begin)) - 1;
+    changed[k] |= ((word ^ oldRow[k + 1]) & valid) != 0;
+    // sin ramas: viva suma uno hasta 255, muerta vuelve a cero
+    for (int j = begin; j < end; ++j) {
+      const std::uint8_t alive = static_cast<std::uint8_t>((word >> (j - begin)) & 1);
+      const std::uint8_t a = age[j];
+      age[j] = static_cast<std::uint8_t>((a + (a != 255)) & -alive);
+    }
+  }
+}
+
+void CellStats::endGeneration() {
+  for (std::size_t t = 0; t < activity_.size(); ++t) {
+    activity_[t] += changed_[t];
+    changed_[t] = 0;
+  }
+  ++generations_;
+}
+
+// La edad distingue ya viva (> 0) de muerta (0), así que no hace falta el
+// estado anterior para saber qué células ha cambiado la edición
+void CellStats::editRect(const Bitboard& board, int rowBegin, int colBegin, int rowEnd, int colEnd) {
+  rowBegin = std::max(rowBegin, 0);
+  colBegin = std::max(colBegin, 0);
+  rowEnd = std::min(rowEnd, rows_);
+  colEnd = std::min(colEnd, cols_);
+  for (int i = rowBegin; i < rowEnd; ++i) {
+    std::uint8_t* age = age_.data() + static_cast<std::size_t>(i) * cols_;
+    std::uint8_t* changed = changed_.data() + static_cast<std::size_t>(i / kTile) * tileCols_;
+    for (int j = colBegin; j < colEnd; ++j) {
+      const bool alive = board.get(i, j);
+      if (alive != (age[j] > 0)) {
+        age[j] = alive;
+        changed[j / kTile] = 1;
+      }
+    }
+  }
+}
+
+// Las edades se copian desplazadas. La actividad de cada baldosa pasa a la
+// baldosa nueva que contiene su esquina, una aproximación porque la rejilla de
+// baldosas no se desplaza con el tablero
+void CellStats::grow(int top, int left, int bottom, int right) {
+  const int rows = rows_ + top + bottom;
+  const int cols = cols_ + left + right;
+  std::vector<std::uint8_t> age(static_cast<std::size_t>(rows) * cols, 0);
+  for (int i = 0; i < rows_; ++i) {
+    std::copy(age_.begin() + static_cast<std::size_t>(i) * cols_, age_.begin() + static_cast<std::size_t>(i + 1) * cols_,
+              age.begin() + static_cast<std::size_t>(i + top) * cols + left);
+  }
+
+  const int tileRows = (rows + kTile - 1) / kTile;
+  const int tileCols = (cols + kTile - 1) / kTile;
+  std::vector<std::uint32_t> activity(static_cast<std::size_t>(tileRows) * tileCols, 0);
+  for (int r = 0; r < tileRows_; ++r) {
+    for (int c = 0; c < tileCols_; ++c) {
+      const int tr = (r * kTile + top) / kTile;
+      const int tc = (c * kTile + left) / kTile;
+      std::uint32_t& target = activity[static_cast<std::size_t>(tr) * tileCols + tc];
+      target = std::max(target, activity_[static_cast<std::size_t>(r) * tileCols_ + c]);
+    }
+  }
+
+  rows_ = rows;
+  cols_ = cols;
+  words_ = (cols + 63) / 64;
+  tileRows_ = tileRows;
+  tileCols_ = tileCols;
+  age_.swap(age);
+  activity_.swap(activity);
+  changed_.assign(activity_.size(), 0);
+}
+
+std::uint8_t CellStats::age(int i, int j) const {
+  return age_[static_cast<std::size_t>(i) * cols_ + j];
+}
+
+std::uint32_t CellStats::activity(int tileRow, int tileCol) const {
+  return activity_[static_cast<std::size_t>(tileRow) * tileCols_ + tileCol];
+}
+
+static bool openOutput(std::ofstream& file, const char* filename) {
+  file.open(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool CellStats::writeAgePgm(const char* filename) const {
+  std::ofstream file;
+  if (!openOutput(file, filename)) {
+    return false;
+  }
+  file << "P5\n" << cols_ << " " << rows_ << "\n255\n";
+  file.write(reinterpret_cast<const char*>(age_.data()), age_.size());
+  return static_cast<bool>(file);
+}
+
+bool CellStats::writeActivityPgm(const char* filename) const {
+  std::ofstream file;
+  if (!openOutput(file, filename)) {
+    return false;
+  }
+  const std::uint32_t peak = activity_.empty() ? 0 : *std::max_element(activity_.begin(), activity_.end());
+  std::vector<std::uint8_t> pixels(activity_.size());
+  for (std::size_t t = 0; t < activity_.size(); ++t) {
+    pixels[t] = peak == 0 ? 0 : static_cast<std::uint8_t>(std::uint64_t(activity_[t]) * 255 / peak);
+  }
+  file << "P5\n" << tileCols_ << " " << tileRows_ << "\n255\n";
+  file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+  return static_cast<bool>(file);
+}
+
+bool CellStats::writeAgeBinary(const char* filename) const {
+  std::ofstream file;
+  if (!openOutput(file, filename)) {
+    return false;
+  }
+  const std::uint32_t size[2] = {static_cast<std::uint32_t>(rows_), static_cast<std::uint32_t>(cols_)};
+  file.write("LGAGE1", 6);
+  file.write(reinterpret_cast<const char*>(size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(age_.data()), age_.size());
+  return static_cast<bool>(file);
+}
+
+bool CellStats::writeActivityBinary(const char* filename) const {
+  std::ofstream file;
+  if (!openOutput(file, filename)) {
+    return false;
+  }
+  const std::uint32_t size[2] = {static_cast<std::uint32_t>(tileRows_), static_cast<std::uint32_t>(tileCols_)};
+  file.write("LGACT1", 6);
+  file.write(reinterpret_cast<const char*>(size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(activity_.data()), activity_.size() * sizeof(std::uint32_t));
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,469 @@
+#include "distributed.h"
+#include "bitboard.h"
+#include "textboard.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Órdenes del coordinador a los trabajadores
+enum Operation { kStep = 0, kPopulation, kSave, kQuit };
+
+// Respuesta de load() cuando el trabajador no pudo abrir el fichero; las demás
+// respuestas negativas son -(fila + 1)
+static const std::int64_t kOpenFailed = std::numeric_limits<std::int64_t>::min();
+
+struct Command {
+  std::int32_t op;
+  std::int64_t arg;
+  char path[512];
+};
+
+// Lectura y escritura completas sobre un canal de órdenes (socket bloqueante)
+static bool readAll(int fd, void* data, std::size_t bytes) {
+  char* p = static_cast<char*>(data);
+  while (bytes > 0) {
+    ssize_t n = read(fd, p, bytes);
+    if (n > 0) {
+      p += n;
+      bytes -= n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool writeAll(int fd, const void* data, std::size_t bytes) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    ssize_t n = send(fd, p, bytes, MSG_NOSIGNAL);
+    if (n > 0) {
+      p += n;
+      bytes -= n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Límites del bloque k de un reparto de n filas o columnas entre parts procesos
+static int blockBegin(int n, int parts, int k) {
+  return static_cast<int>(static_cast<std::int64_t>(n) * k / parts);
+}
+
+// Datos de un trabajador y de su bloque
+struct WorkerInfo {
+  int rows;               // tamaño del tablero completo
+  int cols;
+  int rowBegin;           // bloque propio [rowBegin, rowEnd) x [colBegin, colEnd)
+  int rowEnd;
+  int colBegin;
+  int colEnd;
+  Frontera frontera;
+  std::size_t headerBytes;
+  const char* filename;
+};
+
+// Copiar la columna j del interior a un vector de bits y al revés
+static void packColumn(const Bitboard& board, int j, std::vector<unsigned char>& bytes) {
+  std::fill(bytes.begin(), bytes.end(), 0);
+  for (int i = 0; i < board.getRows(); ++i) {
+    bytes[i >> 3] |= static_cast<unsigned char>(board.get(i, j)) << (i & 7);
+  }
+}
+
+static void unpackColumn(Bitboard& board, int j, const std::vector<unsigned char>& bytes) {
+  for (int i = 0; i < board.getRows(); ++i) {
+    board.set(i, j, (bytes[i >> 3] >> (i & 7)) & 1);
+  }
+}
+
+class Worker {
+public:
+  Worker(const WorkerInfo& info, Transport& transport)
+      : info_(info), transport_(transport),
+        board_(info.rowEnd - info.rowBegin, info.colEnd - info.colBegin),
+        next_(info.rowEnd - info.rowBegin, info.colEnd - info.colBegin) {
+    const std::size_t columnBytes = (board_.getRows() + 7) / 8;
+    sendLeft_.resize(columnBytes);
+    sendRight_.resize(columnBytes);
+    recvLeft_.resize(columnBytes);
+    recvRight_.resize(columnBytes);
+    // las fronteras abiertas dan un halo constante en los bordes del tablero
+    temp_ = (info.frontera == Frontera::abiertaCaliente);
+    constantColumn_.assign(columnBytes, temp_ ? 0xff : 0);
+  }
+
+  // Leer el bloque propio del fichero. Devuelve 0, -(fila + 1) si una fila no es
+  // válida o kOpenFailed si no se pudo abrir
+  std::int64_t load() {
+    int fd = open(info_.filename, O_RDONLY);
+    if (fd < 0) {
+      return kOpenFailed;
+    }
+    const bool lastBlock = (info_.colEnd == info_.cols);
+    const int width = board_.getCols();
+    std::vector<char> buffer(width + 1);
+    for (int i = 0; i < board_.getRows(); ++i) {
+      const std::int64_t global = info_.rowBegin + i;
+      const off_t offset = info_.headerBytes + global * (info_.cols + 1) + info_.colBegin;
+      const std::size_t bytes = width + (lastBlock ? 1 : 0);
+      if (pread(fd, buffer.data(), bytes, offset) != static_cast<ssize_t>(bytes) ||
+          (lastBlock && buffer[width] != '\n')) {
+        close(fd);
+        return -(global + 1);
+      }
+      packTextRow(buffer.data(), width, board_.row(i) + 1);
+    }
+    close(fd);
+    return 0;
+  }
+
+  // Una generación: el intercambio de halos se solapa con el cálculo del interior
+  void step() {
+    const int h = board_.getRows();
+    const int words = board_.getWords();
+    const std::size_t columnBytes = sendLeft_.size();
+    const std::size_t rowBytes = board_.getStride() * sizeof(std::uint64_t);
+
+    // Fase 1: columnas de halo de las filas interiores
+    if (transport_.hasLink(kLeft)) {
+      packColumn(board_, 0, sendLeft_);
+      transport_.post(kLeft, sendLeft_.data(), recvLeft_.data(), columnBytes);
+    }
+    if (transport_.hasLink(kRight)) {
+      packColumn(board_, board_.getCols() - 1, sendRight_);
+      transport_.post(kRight, sendRight_.data(), recvRight_.data(), columnBytes);
+    }
+    // células que no tocan el halo
+    board_.stepRegion(next_, 1, h - 1, 2, words);
+    transport_.wait();
+    unpackColumn(board_, -1, transport_.hasLink(kLeft) ? recvLeft_ : constantColumn_);
+    unpackColumn(board_, board_.getCols(), transport_.hasLink(kRight) ? recvRight_ : constantColumn_);
+
+    // Fase 2: filas de halo completas, que ya llevan las esquinas
+    const std::uint64_t fill = temp_ ? ~std::uint64_t(0) : 0;
+    if (transport_.hasLink(kUp)) {
+      transport_.post(kUp, board_.row(0), board_.row(-1), rowBytes);
+    } else {
+      std::fill(board_.row(-1), board_.row(-1) + board_.getStride(), fill);
+    }
+    if (transport_.hasLink(kDown)) {
+      transport_.post(kDown, board_.row(h - 1), board_.row(h), rowBytes);
+    } else {
+      std::fill(board_.row(h), board_.row(h) + board_.getStride(), fill);
+    }
+    // primera y última palabra de las filas interiores
+    board_.stepRegion(next_, 1, h - 1, 1, 2);
+    if (words > 1) {
+      board_.stepRegion(next_, 1, h - 1, words, words + 1);
+    }
+    transport_.wait();
+    board_.stepRegion(next_, 0, 1, 1, words + 1);
+    if (h > 1) {
+      board_.stepRegion(next_, h - 1, h, 1, words + 1);
+    }
+
+    board_.swap(next_);
+  }
+
+  std::int64_t population() const {
+    return board_.population();
+  }
+
+  // Escribir las filas propias en su posición del fichero de salida
+  std::int64_t save(const char* filename, std::int64_t headerBytes) const {
+    int fd = open(filename, O_WRONLY);
+    if (fd < 0) {
+      return -1;
+    }
+    const bool lastBlock = (info_.colEnd == info_.cols);
+    const int width = board_.getCols();
+    std::vector<char> buffer(width + 1, '\n');
+    for (int i = 0; i < board_.getRows(); ++i) {
+      for (int j = 0; j < width; ++j) {
+        buffer[j] = board_.get(i, j) ? 'X' : ' ';
+      }
+      const std::int64_t global = info_.rowBegin + i;
+      const off_t offset = headerBytes + global * (info_.cols + 1) + info_.colBegin;
+      const std::size_t bytes = width + (lastBlock ? 1 : 0);
+      if (pwrite(fd, buffer.data(), bytes, offset) != static_cast<ssize_t>(bytes)) {
+        close(fd);
+        return -1;
+      }
+    }
+    close(fd);
+    return 0;
+  }
+
+private:
+  WorkerInfo info_;
+  Transport& transport_;
+  Bitboard board_;
+  Bitboard next_;
+  bool temp_;
+  std::vector<unsigned char> sendLeft_, sendRight_, recvLeft_, recvRight_;
+  std::vector<unsigned char> constantColumn_;
+};
+
+// Bucle de un proceso trabajador: atiende órdenes hasta kQuit o hasta que se cierra el canal
+static int runWorker(int control, const WorkerInfo& info, Transport& transport) {
+  Worker worker(info, transport);
+  std::int64_t reply = worker.load();
+  if (!writeAll(control, &reply, sizeof(reply)) || reply != 0) {
+    return 1;
+  }
+
+  Command command;
+  while (readAll(control, &command, sizeof(command))) {
+    switch (command.op) {
+      case kStep:
+        for (std::int64_t g = 0; g < command.arg; ++g) {
+          worker.step();
+        }
+        reply = 0;
+        break;
+      case kPopulation:
+        reply = worker.population();
+        break;
+      case kSave:
+        reply = worker.save(command.path, command.arg);
+        break;
+      default:
+        return 0;
+    }
+    if (!writeAll(control, &reply, sizeof(reply))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+DistributedLattice::DistributedLattice(const char* filename, int procRows, int procCols, Frontera frontera,
+                                       TransportKind kind) {
+  rows = 0;
+  cols = 0;
+  procRows_ = procRows;
+  procCols_ = procCols;
+  headerBytes_ = 0;
+  ready_ = false;
+
+  // Leer solo la cabecera: las filas las lee cada trabajador
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return;
+  }
+  std::string header;
+  std::getline(file, header);
+  std::istringstream dimensions(header);
+  if (!(dimensions >> rows >> cols) || rows <= 0 || cols <= 0) {
+    std::cerr << "Error: Cabecera no válida en el archivo " << filename << std::endl;
+    return;
+  }
+  file.close();
+  headerBytes_ = header.length() + 1;
+
+  if (procRows < 1 || procCols < 1 || procRows > rows || procCols > cols) {
+    std::cerr << "Error: La rejilla de procesos no cabe en el retículo." << std::endl;
+    return;
+  }
+
+  struct stat info;
+  if (stat(filename, &info) != 0 ||
+      static_cast<std::int64_t>(info.st_size) != static_cast<std::int64_t>(headerBytes_) +
+                                                     static_cast<std::int64_t>(rows) * (cols + 1)) {
+    std::cerr << "Error: La longitud de la fila no coincide con el número de columnas especificado." << std::endl;
+    return;
+  }
+
+  // Tamaño máximo de un mensaje: una fila empaquetada del bloque más ancho
+  // o una columna del bloque más alto
+  const int maxCols = cols / procCols + 1;
+  const int maxRows = rows / procRows + 1;
+  const std::size_t maxMessage = std::max<std::size_t>(((maxCols + 63) / 64 + 2) * sizeof(std::uint64_t),
+                                                       (maxRows + 7) / 8);
+  std::unique_ptr<TransportNetwork> network =
+      makeTransportNetwork(kind, procRows, procCols, frontera == Frontera::periodic, maxMessage);
+
+  for (int p = 0; p < procRows; ++p) {
+    for (int q = 0; q < procCols; ++q) {
+      int sv[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+        std::cerr << "Error: No se pudo crear el canal de órdenes." << std::endl;
+        return;
+      }
+      pid_t pid = fork();
+      if (pid < 0) {
+        std::cerr << "Error: No se pudo arrancar un trabajador." << std::endl;
+        close(sv[0]);
+        close(sv[1]);
+        return;
+      }
+      if (pid == 0) {
+        // Proceso trabajador
+        close(sv[0]);
+        for (int fd : control_) {
+          close(fd);
+        }
+        WorkerInfo worker;
+        worker.rows = rows;
+        worker.cols = cols;
+        worker.rowBegin = blockBegin(rows, procRows, p);
+        worker.rowEnd = blockBegin(rows, procRows, p + 1);
+        worker.colBegin = blockBegin(cols, procCols, q);
+        worker.colEnd = blockBegin(cols, procCols, q + 1);
+        worker.frontera = frontera;
+        worker.headerBytes = headerBytes_;
+        worker.filename = filename;
+        int status = 1;
+        try {
+          std::unique_ptr<Transport> transport = network->endpoint(p, q);
+          status = runWorker(sv[1], worker, *transport);
+        } catch (const std::exception& e) {
+          std::cerr << "Error en el trabajador (" << p << ", " << q << "): " << e.what() << std::endl;
+        }
+        _exit(status);
+      }
+      close(sv[1]);
+      workers_.push_back(pid);
+      control_.push_back(sv[0]);
+    }
+  }
+  // los extremos de los enlaces ya solo los usan los trabajadores
+  network->release();
+
+  // Cada trabajador confirma que ha leído su bloque
+  ready_ = true;
+  for (int fd : control_) {
+    std::int64_t reply = kOpenFailed;
+    if (!readAll(fd, &reply, sizeof(reply)) || reply != 0) {
+      if (reply < 0 && reply != kOpenFailed) {
+        std::cerr << "Error: La longitud de la fila " << -reply - 1
+                  << " no coincide con el número de columnas especificado." << std::endl;
+      } else if (ready_) {
+        std::cerr << "Error: No se pudo leer el archivo " << filename << std::endl;
+      }
+      ready_ = false;
+    }
+  }
+}
+
+DistributedLattice::~DistributedLattice() {
+  Command command;
+  std::memset(&command, 0, sizeof(command));
+  command.op = kQuit;
+  for (int fd : control_) {
+    writeAll(fd, &command, sizeof(command));
+    close(fd);
+  }
+  for (pid_t pid : workers_) {
+    waitpid(pid, nullptr, 0);
+  }
+}
+
+bool DistributedLattice::isReady() const {
+  return ready_;
+}
+
+int DistributedLattice::getRows() const {
+  return rows;
+}
+
+int DistributedLattice::getCols() const {
+  return cols;
+}
+
+bool DistributedLattice::broadcast(int op, std::int64_t arg, const char* path,
+                                   std::vector<std::int64_t>& replies) const {
+  if (!ready_) {
+    return false;
+  }
+  Command command;
+  std::memset(&command, 0, sizeof(command));
+  command.op = op;
+  command.arg = arg;
+  if (path != nullptr) {
+    // una ruta recortada haría que los trabajadores abrieran otro fichero
+    if (std::strlen(path) >= sizeof(command.path)) {
+      std::cerr << "Error: La ruta " << path << " es demasiado larga (máximo " << sizeof(command.path) - 1
+                << " caracteres)." << std::endl;
+      return false;
+    }
+    std::strcpy(command.path, path);
+  }
+  // primero se envía a todos para que trabajen a la vez, luego se recogen las respuestas
+  bool ok = true;
+  for (int fd : control_) {
+    ok = writeAll(fd, &command, sizeof(command)) && ok;
+  }
+  replies.assign(control_.size(), 0);
+  for (std::size_t w = 0; w < control_.size(); ++w) {
+    ok = readAll(control_[w], &replies[w], sizeof(replies[w])) && ok;
+  }
+  return ok;
+}
+
+void DistributedLattice::nextGeneration(int generations) {
+  std::vector<std::int64_t> replies;
+  if (!broadcast(kStep, generations, nullptr, replies)) {
+    std::cerr << "Error: Se ha perdido la comunicación con los trabajadores." << std::endl;
+  }
+}
+
+std::size_t DistributedLattice::Population() const {
+  std::vector<std::int64_t> replies;
+  if (!broadcast(kPopulation, 0, nullptr, replies)) {
+    std::cerr << "Error: Se ha perdido la comunicación con los trabajadores." << std::endl;
+    return 0;
+  }
+  std::size_t aliveCount = 0;
+  for (std::int64_t count : replies) {
+    aliveCount += count;
+  }
+  return aliveCount;
+}
+
+void DistributedLattice::saveToFile(const char* filename) const {
+  // El coordinador escribe la cabecera y reserva el tamaño final del fichero;
+  // cada trabajador rellena después sus filas con pwrite()
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return;
+  }
+  file << rows << " " << cols << std::endl;
+  const std::int64_t header = file.tellp();
+  file.close();
+  if (truncate(filename, header + static_cast<std::int64_t>(rows) * (cols + 1)) != 0) {
+    std::cerr << "Error: No se pudo reservar el archivo " << filename << std::endl;
+    return;
+  }
+
+  // la cabecera puede no medir lo mismo que la del fichero de entrada
+  std::vector<std::int64_t> replies;
+  bool ok = broadcast(kSave, header, filename, replies);
+  for (std::int64_t reply : replies) {
+    ok = ok && reply == 0;
+  }
+  if (!ok) {
+    std::cerr << "Error: No se pudo escribir el archivo " << filename << std::endl;
+  }
+}
@@ -0,0 +1,326 @@
+#include "engine.h"
+
+#include <algorithm>
+#include "cell.h"
+
+bool parseEngine(const std::string& nombre, EngineKind& kind) {
+  if (nombre == "scalar") {
+    kind = EngineKind::scalar;
+  } else if (nombre == "bitsliced") {
+    kind = EngineKind::bitSliced;
+  } else if (nombre == "lut") {
+    kind = EngineKind::lut;
+  } else if (nombre == "tiled") {
+    kind = EngineKind::tiled;
+  } else if (nombre == "auto") {
+    kind = EngineKind::adaptive;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string engineToString(EngineKind kind) {
+  switch (kind) {
+    case EngineKind::scalar:
+      return "scalar";
+    case EngineKind::bitSliced:
+      return "bitsliced";
+    case EngineKind::lut:
+      return "lut";
+    case EngineKind::tiled:
+      return "tiled";
+    case EngineKind::adaptive:
+      return "auto";
+  }
+  return "";
+}
+
+// ---------------------------------------------------------------------------
+// Escalar: tres filas desempaquetadas a bytes para que el bucle de la regla no
+// tenga accesos a bits ni llamadas y el compilador pueda vectorizarlo
+
+// Desempaquetar la fila i (con sus dos columnas de halo) a un byte por célula
+static void unpackRow(const Bitboard& board, int i, unsigned char* out) {
+  const int cols = board.getCols();
+  for (int j = -1; j <= cols; ++j) {
+    out[j + 1] = board.get(i, j);
+  }
+}
+
+class ScalarEngine : public Engine {
+public:
+  EngineKind kind() const override {
+    return EngineKind::scalar;
+  }
+
+  void step(const Bitboard& board, Bitboard& next, CellStats* stats) override {
+    const int rows = board.getRows();
+    const int cols = board.getCols();
+    up_.resize(cols + 2);
+    mid_.resize(cols + 2);
+    down_.resize(cols + 2);
+    out_.resize(cols + 2);
+    // punteros locales: con los vectores miembro el compilador no puede descartar
+    // que se solapen y deja el bucle sin vectorizar
+    unsigned char* up = up_.data();
+    unsigned char* mid = mid_.data();
+    unsigned char* down = down_.data();
+    unsigned char* outRow = out_.data();
+    unpackRow(board, -1, up);
+    unpackRow(board, 0, mid);
+    for (int i = 0; i < rows; i++)
+    {
+      unpackRow(board, i + 1, down);
+      for (int j = 1; j <= cols; j++)
+      {
+        // vecinos vivos de cada celula
+        const int aliveCount = up[j - 1] + up[j] + up[j + 1]
+                             + mid[j - 1] + mid[j + 1]
+                             + down[j - 1] + down[j] + down[j + 1];
+        outRow[j] = Cell::transitionFunction(mid[j], aliveCount); // estado siguiente segun funcion transic.
+      }
+
+      // volver a empaquetar la fila
+      std::uint64_t* out = next.row(i);
+      for (int k = 0; k < next.getWords(); ++k) {
+        const int begin = k * 64;
+        const int end = std::min(begin + 64, cols);
+        std::uint64_t word = 0;
+        for (int j = begin; j < end; ++j) {
+          word |= static_cast<std::uint64_t>(outRow[j + 1]) << (j - begin);
+        }
+        out[k + 1] = word;
+      }
+      // con la fila aún en caché
+      if (stats != nullptr)
+      {
+        stats->updateRow(i, board.row(i), out);
+      }
+
+      // rotar las filas sin copiarlas
+      unsigned char* oldUp = up;
+      up = mid;
+      mid = down;
+      down = oldUp;
+    }
+  }
+
+private:
+  std::vector<unsigned char> up_, mid_, down_, out_;
+};
+
+// ---------------------------------------------------------------------------
+// Bit-sliced: Bitboard::stepRegion fila a fila
+
+class BitSlicedEngine : public Engine {
+public:
+  EngineKind kind() const override {
+    return EngineKind::bitSliced;
+  }
+
+  void step(const Bitboard& board, Bitboard& next, CellStats* stats) override {
+    if (stats == nullptr) {
+      board.step(next);
+      return;
+    }
+    for (int i = 0; i < board.getRows(); ++i) {
+      board.stepRegion(next, i, i + 1, 1, board.getWords() + 1);
+      stats->updateRow(i, board.row(i), next.row(i));
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Tabla de bloques 2x2
+
+class LutEngine : public Engine {
+public:
+  explicit LutEngine(const Rule& rule) : kernel_(rule) {}
+
+  EngineKind kind() const override {
+    return EngineKind::lut;
+  }
+
+  void step(const Bitboard& board, Bitboard& next, CellStats* stats) override {
+    kernel_.step(board, next, stats);
+  }
+
+private:
+  LutKernel kernel_;
+};
+
+// ---------------------------------------------------------------------------
+// Por baldosas: una baldosa (kTile filas x una palabra) solo se recalcula si
+// ella o alguna de sus ocho vecinas cambió en la generación anterior. Las demás
+// no se tocan: next guarda la generación anterior, que en una baldosa quieta es
+// igual a la actual. Las baldosas del borde se recalculan siempre porque el halo
+// puede cambiar sin que cambie ninguna baldosa (frontera periódica).
+
+class TiledEngine : public Engine {
+public:
+  EngineKind kind() const override {
+    return EngineKind::tiled;
+  }
+
+  void reset() override {
+    changed_.clear();
+  }
+
+  void step(const Bitboard& board, Bitboard& next, CellStats* stats) override {
+    const int rows = board.getRows();
+    const int words = board.getWords();
+    const int tileRows = (rows + CellStats::kTile - 1) / CellStats::kTile;
+    // sin historia (primera generación o tras reset) se recalcula todo
+    const bool fresh = static_cast<int>(changed_.size()) != tileRows * words || next.getRows() != rows ||
+                       next.getCols() != board.getCols();
+    if (fresh) {
+      changed_.assign(static_cast<std::size_t>(tileRows) * words, 1);
+    }
+
+    std::vector<std::uint8_t> needed(changed_.size(), 0);
+    for (int tr = 0; tr < tileRows; ++tr) {
+      for (int tc = 0; tc < words; ++tc) {
+        bool need = fresh || tr == 0 || tr == tileRows - 1 || tc == 0 || tc == words - 1;
+        for (int dr = -1; dr <= 1 && !need; ++dr) {
+          for (int dc = -1; dc <= 1 && !need; ++dc) {
+            const int r = tr + dr;
+            const int c = tc + dc;
+            need = r >= 0 && r < tileRows && c >= 0 && c < words && changed_[r * words + c];
+          }
+        }
+        needed[tr * words + tc] = need;
+      }
+    }
+
+    // el bit de la columna cols del halo cae en el relleno de la última palabra
+    const std::uint64_t mask = board.lastWordMask();
+    std::fill(changed_.begin(), changed_.end(), 0);
+    for (int tr = 0; tr < tileRows; ++tr) {
+      const int rowBegin = tr * CellStats::kTile;
+      const int rowEnd = std::min(rowBegin + CellStats::kTile, rows);
+      const std::uint8_t* need = needed.data() + tr * words;
+      std::uint8_t* changed = changed_.data() + tr * words;
+      for (int i = rowBegin; i < rowEnd; ++i) {
+        // tramos seguidos de baldosas a recalcular en esta fila
+        for (int tc = 0; tc < words;) {
+          if (!need[tc]) {
+            ++tc;
+            continue;
+          }
+          int end = tc;
+          while (end < words && need[end]) {
+            ++end;
+          }
+          board.stepRegion(next, i, i + 1, tc + 1, end + 1);
+          for (int c = tc; c < end; ++c) {
+            const std::uint64_t diff = board.row(i)[c + 1] ^ next.row(i)[c + 1];
+            changed[c] |= (c == words - 1 ? diff & mask : diff) != 0;
+          }
+          tc = end;
+        }
+        if (stats != nullptr) {
+          stats->updateRow(i, board.row(i), next.row(i));
+        }
+      }
+    }
+  }
+
+private:
+  std::vector<std::uint8_t> changed_; // baldosas que cambiaron en la última generación
+};
+
+std::unique_ptr<Engine> makeEngine(EngineKind kind, const Rule& rule) {
+  switch (kind) {
+    case EngineKind::bitSliced:
+      return std::unique_ptr<Engine>(new BitSlicedEngine());
+    case EngineKind::lut:
+      return std::unique_ptr<Engine>(new LutEngine(rule));
+    case EngineKind::tiled:
+      return std::unique_ptr<Engine>(new TiledEngine());
+    case EngineKind::scalar:
+    case EngineKind::adaptive:
+      break;
+  }
+  return std::unique_ptr<Engine>(new ScalarEngine());
+}
+
+// ---------------------------------------------------------------------------
+// Política adaptativa
+
+double changedTileFraction(const Bitboard& before, const Bitboard& after) {
+  const int rows = after.getRows();
+  const int words = after.getWords();
+  if (before.getRows() != rows || before.getCols() != after.getCols() || rows == 0) {
+    return 1.0;
+  }
+  const int tileRows = (rows + CellStats::kTile - 1) / CellStats::kTile;
+  std::vector<std::uint8_t> changed(static_cast<std::size_t>(tileRows) * words, 0);
+  const std::uint64_t mask = after.lastWordMask();
+  for (int i = 0; i < rows; ++i) {
+    const std::uint64_t* a = before.row(i);
+    const std::uint64_t* b = after.row(i);
+    std::uint8_t* tile = changed.data() + static_cast<std::size_t>(i / CellStats::kTile) * words;
+    for (int k = 1; k <= words; ++k) {
+      const std::uint64_t diff = a[k] ^ b[k];
+      tile[k - 1] |= (k == words ? diff & mask : diff) != 0;
+    }
+  }
+  return static_cast<double>(std::count(changed.begin(), changed.end(), 1)) / changed.size();
+}
+
+// Umbrales de la fracción de baldosas cambiadas: se entra en tiled por debajo
+// de la primera y se sale por encima de la segunda
+static const double kEnterTiled = 0.2;
+static const double kLeaveTiled = 0.4;
+// Densidad dentro de la caja de las células vivas a partir de la cual la caja
+// pequeña ya no favorece a tiled: casi todas sus baldosas cambian
+static const double kDenseBox = 0.15;
+
+EnginePolicy::EnginePolicy(const Rule& rule) {
+  conway_ = rule.isConway();
+  candidate_ = EngineKind::bitSliced;
+  votes_ = 0;
+}
+
+// El bit-sliced es el más rápido en tableros activos. Con pocas baldosas
+// cambiando gana tiled, y también con algo más de actividad si la caja de las
+// células vivas ocupa poco, no crece deprisa y está poco poblada. Fuera de
+// B3/S23 solo vale lut.
+//
+// No hay un núcleo de trozos dispersos aparte: tiled ya cubre ese caso, porque
+// una baldosa vacía no cambia y no se recalcula, así que un tablero con unos
+// pocos grupos de células cuesta lo que cuestan sus baldosas ocupadas. Lo que
+// ahorraría además un almacenamiento disperso es memoria, y todos los núcleos
+// comparten el Bitboard denso (un bit por célula) para poder cambiar de uno a
+// otro sin convertir el tablero.
+EngineKind EnginePolicy::preferred(EngineKind current, const EngineSample& sample) const {
+  if (!conway_) {
+    return EngineKind::lut;
+  }
+  const double threshold = current == EngineKind::tiled ? kLeaveTiled : kEnterTiled;
+  if (sample.changedTiles < threshold) {
+    return EngineKind::tiled;
+  }
+  const double boxDensity = sample.boundingBoxArea > 0 ? sample.density / sample.boundingBoxArea : 0;
+  if (sample.boundingBoxArea < 0.5 && sample.boundingBoxGrowth < 1.1 && boxDensity < kDenseBox &&
+      sample.changedTiles < 2 * threshold) {
+    return EngineKind::tiled;
+  }
+  return EngineKind::bitSliced;
+}
+
+EngineKind EnginePolicy::decide(EngineKind current, const EngineSample& sample) {
+  const EngineKind best = preferred(current, sample);
+  if (best == current) {
+    votes_ = 0;
+    return current;
+  }
+  votes_ = best == candidate_ ? votes_ + 1 : 1;
+  candidate_ = best;
+  if (votes_ >= 2) {
+    votes_ = 0;
+    return best;
+  }
+  return current;
+}
@@ -0,0 +1,193 @@
+#include "framestream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+bool parseFrameFormat(const std::string& nombre, FrameFormat& format) {
+  if (nombre == "pbm") {
+    format = FrameFormat::pbm;
+  } else if (nombre == "pgm") {
+    format = FrameFormat::pgm;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Bitboard guarda la columna más a la izquierda en el bit menos significativo y
+// PBM en el más significativo, así que cada byte se invierte con una tabla
+struct ReverseTable {
+  unsigned char bits[256];
+  ReverseTable() {
+    for (int b = 0; b < 256; ++b) {
+      unsigned char reversed = 0;
+      for (int k = 0; k < 8; ++k) {
+        reversed |= ((b >> k) & 1) << (7 - k);
+      }
+      bits[b] = reversed;
+    }
+  }
+};
+static const ReverseTable kReverse;
+
+FrameStream::FrameStream(const char* filename, FrameFormat format, int every, int zoom) {
+  format_ = format;
+  every_ = std::max(every, 1);
+  zoom_ = std::max(zoom, 1);
+  fd_ = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+  }
+}
+
+FrameStream::~FrameStream() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool FrameStream::isOpen() const {
+  return fd_ >= 0;
+}
+
+void FrameStream::write(std::size_t generation, const Bitboard& board) {
+  if (fd_ < 0 || generation % every_ != 0) {
+    return;
+  }
+  if (format_ == FrameFormat::pbm) {
+    writePbm(board);
+  } else {
+    writePgm(board);
+  }
+}
+
+// Las filas se copian palabra a palabra: los bytes de cada palabra ya están en el
+// orden de las columnas (little-endian) y solo hay que invertir sus bits
+void FrameStream::writePbm(const Bitboard& board) {
+  const int rows = board.getRows();
+  const int cols = board.getCols();
+  const std::size_t rowBytes = (cols + 7) / 8;
+  staging_.resize(rowBytes * rows);
+
+  // bits de relleno del último byte de cada fila
+  const unsigned char lastByteMask = (cols % 8) == 0 ? 0xFF : static_cast<unsigned char>(0xFF << (8 - cols % 8));
+  for (int i = 0; i < rows; ++i) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(board.row(i) + 1);
+    unsigned char* out = staging_.data() + rowBytes * i;
+    for (std::size_t b = 0; b < rowBytes; ++b) {
+      out[b] = kReverse.bits[in[b]];
+    }
+    if (rowBytes > 0) {
+      out[rowBytes - 1] &= lastByteMask;
+    }
+  }
+  writeFrame("P4\n" + std::to_string(cols) + " " + std::to_string(rows) + "\n");
+}
+
+// Mapa de densidad: cada píxel resume un bloque zoom x zoom con popcount por palabra
+void FrameStream::writePgm(const Bitboard& board) {
+  const int rows = board.getRows();
+  const int cols = board.getCols();
+  const int height = (rows + zoom_ - 1) / zoom_;
+  const int width = (cols + zoom_ - 1) / zoom_;
+  staging_.resize(static_cast<std::size_t>(height) * width);
+
+  std::vector<int> counts(width);
+  for (int r = 0; r < height; ++r) {
+    const int rowBegin = r * zoom_;
+    const int rowEnd = std::min(rowBegin + zoom_, rows);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int i = rowBegin; i < rowEnd; ++i) {
+      for (int c = 0; c < width; ++c) {
+        counts[c] += board.countRange(i, c * zoom_, std::min((c + 1) * zoom_, cols));
+      }
+    }
+    unsigned char* out = staging_.data() + static_cast<std::size_t>(width) * r;
+    for (int c = 0; c < width; ++c) {
+      const int cells = (rowEnd - rowBegin) * (std::min((c + 1) * zoom_, cols) - c * zoom_);
+      out[c] = static_cast<unsigned char>(counts[c] * 255 / cells);
+    }
+  }
+  writeFrame("P5\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n");
+}
+
+// Bloquea SIGPIPE en este hilo mientras dura el objeto: si el lector de una
+// tubería se va, writev devuelve EPIPE en vez de terminar el programa. Al salir
+// se descarta la señal que haya quedado pendiente por ello y se restaura la máscara
+class PipeSignalBlock {
+public:
+  PipeSignalBlock() {
+    sigemptyset(&pipe_);
+    sigaddset(&pipe_, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_, &saved_);
+    sigset_t pending;
+    sigpending(&pending);
+    wasPending_ = sigismember(&pending, SIGPIPE) == 1;
+    raised_ = false;
+  }
+
+  ~PipeSignalBlock() {
+    if (raised_ && !wasPending_) {
+      const struct timespec zero = {0, 0};
+      while (sigtimedwait(&pipe_, nullptr, &zero) < 0 && errno == EINTR) {
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &saved_, nullptr);
+  }
+
+  // writev ha devuelto EPIPE y ha dejado un SIGPIPE pendiente
+  void raised() {
+    raised_ = true;
+  }
+
+private:
+  sigset_t pipe_;
+  sigset_t saved_;
+  bool wasPending_;
+  bool raised_;
+};
+
+// Cabecera y cuerpo en una sola llamada, repitiendo si la escritura queda a medias
+void FrameStream::writeFrame(const std::string& header) {
+  struct iovec parts[2];
+  parts[0].iov_base = const_cast<char*>(header.data());
+  parts[0].iov_len = header.size();
+  parts[1].iov_base = staging_.data();
+  parts[1].iov_len = staging_.size();
+
+  PipeSignalBlock block;
+  struct iovec* next = parts;
+  int count = 2;
+  while (count > 0) {
+    ssize_t n = writev(fd_, next, count);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EPIPE) {
+        block.raised();
+      }
+      std::cerr << "Error al escribir un fotograma: " << std::strerror(errno) << std::endl;
+      close(fd_);
+      fd_ = -1;
+      return;
+    }
+    while (count > 0 && static_cast<std::size_t>(n) >= next->iov_len) {
+      n -= next->iov_len;
+      ++next;
+      --count;
+    }
+    if (count > 0) {
+      next->iov_base = static_cast<char*>(next->iov_base) + n;
+      next->iov_len -= n;
+    }
+  }
+}
@@ -0,0 +1,30 @@
+#include "frontera.h"
+
+bool parseFrontera(const std::string& nombre, Frontera& frontera) {
+  if (nombre == "periodic") {
+    frontera = Frontera::periodic;
+  } else if (nombre == "noBorder") {
+    frontera = Frontera::noBorder;
+  } else if (nombre == "abiertaFria") {
+    frontera = Frontera::abiertaFria;
+  } else if (nombre == "abiertaCaliente") {
+    frontera = Frontera::abiertaCaliente;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string fronteraToString(Frontera frontera) {
+  switch (frontera) {
+    case Frontera::periodic:
+      return "periodic";
+    case Frontera::noBorder:
+      return "noBorder";
+    case Frontera::abiertaFria:
+      return "abiertaFria";
+    case Frontera::abiertaCaliente:
+      return "abiertaCaliente";
+  }
+  return "";
+}
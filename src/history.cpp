@@ -0,0 +1,319 @@
+#include "history.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Formato del fichero (enteros en el orden de bytes de la máquina):
+//   cabecera:  "LGHIST01" u32 keyframeInterval
+//   registro:  u8 tipo, u64 generación, u32 filas, u32 columnas, u64 bytes, datos
+//     kKeyframe: las palabras interiores de cada fila, tal cual
+//     kDelta:    rachas (u32 palabras a cero, u32 palabras literales, literales u64)
+//                del XOR con la generación anterior
+//     kIndex:    u64 última generación, u64 n, n pares (u64 generación, u64 posición)
+//   final:     u64 posición del índice, "LGINDEX1"
+static const char kMagic[8] = {'L', 'G', 'H', 'I', 'S', 'T', '0', '1'};
+static const char kIndexMagic[8] = {'L', 'G', 'I', 'N', 'D', 'E', 'X', '1'};
+enum RecordType : std::uint8_t { kKeyframe = 0, kDelta = 1, kIndex = 2 };
+
+template <typename T>
+static void put(std::vector<char>& out, const T& value) {
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static void putRaw(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool getRaw(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Palabra k (de 0 a words - 1) del interior de la fila i, con el relleno a cero
+static inline std::uint64_t interiorWord(const Bitboard& board, int i, int k) {
+  const std::uint64_t word = board.row(i)[k + 1];
+  return k == board.getWords() - 1 ? word & board.lastWordMask() : word;
+}
+
+// ---------------------------------------------------------------------------
+
+HistoryWriter::HistoryWriter(const char* filename, int keyframeInterval)
+    : file_(filename, std::ios::binary | std::ios::trunc) {
+  keyframeInterval_ = std::max(1, keyframeInterval);
+  hasPrevious_ = false;
+  previousGeneration_ = 0;
+  lastKeyframe_ = 0;
+  if (!file_.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return;
+  }
+  file_.write(kMagic, sizeof(kMagic));
+  putRaw(file_, static_cast<std::uint32_t>(keyframeInterval_));
+}
+
+HistoryWriter::~HistoryWriter() {
+  close();
+}
+
+bool HistoryWriter::isOpen() const {
+  return file_.is_open();
+}
+
+void HistoryWriter::append(std::size_t generation, const Bitboard& board) {
+  if (!file_.is_open()) {
+    return;
+  }
+  const bool keyframe = !hasPrevious_ || generation != previousGeneration_ + 1 ||
+                        board.getRows() != previous_.getRows() || board.getCols() != previous_.getCols() ||
+                        generation - lastKeyframe_ >= static_cast<std::size_t>(keyframeInterval_);
+  const int words = board.getWords();
+  std::vector<char> payload;
+
+  if (keyframe) {
+    payload.reserve(static_cast<std::size_t>(board.getRows()) * words * sizeof(std::uint64_t));
+    for (int i = 0; i < board.getRows(); ++i) {
+      for (int k = 0; k < words; ++k) {
+        put(payload, interiorWord(board, i, k));
+      }
+    }
+    index_.push_back(std::make_pair(generation, static_cast<std::uint64_t>(file_.tellp())));
+    lastKeyframe_ = generation;
+  } else {
+    // Rachas sobre la secuencia de palabras XOR de todo el interior
+    std::uint32_t zeros = 0;
+    std::vector<std::uint64_t> literals;
+    auto flush = [&payload, &zeros, &literals]() {
+      put(payload, zeros);
+      put(payload, static_cast<std::uint32_t>(literals.size()));
+      for (std::uint64_t literal : literals) {
+        put(payload, literal);
+      }
+      zeros = 0;
+      literals.clear();
+    };
+    for (int i = 0; i < board.getRows(); ++i) {
+      for (int k = 0; k < words; ++k) {
+        const std::uint64_t change = interiorWord(board, i, k) ^ interiorWord(previous_, i, k);
+        if (change == 0) {
+          if (!literals.empty()) {
+            flush();
+          }
+          ++zeros;
+        } else {
+          literals.push_back(change);
+        }
+      }
+    }
+    if (zeros != 0 || !literals.empty()) {
+      flush();
+    }
+  }
+
+  writeRecord(keyframe ? kKeyframe : kDelta, generation, board, payload);
+  // los fotogramas completos se vuelcan ya, así un fallo pierde como mucho un intervalo
+  if (keyframe) {
+    file_.flush();
+  }
+
+  previous_ = board;
+  previousGeneration_ = generation;
+  hasPrevious_ = true;
+}
+
+void HistoryWriter::writeRecord(std::uint8_t type, std::size_t generation, const Bitboard& board,
+                                const std::vector<char>& payload) {
+  putRaw(file_, type);
+  putRaw(file_, static_cast<std::uint64_t>(generation));
+  putRaw(file_, static_cast<std::uint32_t>(board.getRows()));
+  putRaw(file_, static_cast<std::uint32_t>(board.getCols()));
+  putRaw(file_, static_cast<std::uint64_t>(payload.size()));
+  file_.write(payload.data(), payload.size());
+}
+
+void HistoryWriter::close() {
+  if (!file_.is_open()) {
+    return;
+  }
+  const std::uint64_t indexOffset = file_.tellp();
+  putRaw(file_, static_cast<std::uint8_t>(kIndex));
+  putRaw(file_, static_cast<std::uint64_t>(previousGeneration_));
+  putRaw(file_, static_cast<std::uint64_t>(index_.size()));
+  for (const auto& entry : index_) {
+    putRaw(file_, entry.first);
+    putRaw(file_, entry.second);
+  }
+  putRaw(file_, indexOffset);
+  file_.write(kIndexMagic, sizeof(kIndexMagic));
+  file_.close();
+}
+
+// ---------------------------------------------------------------------------
+
+HistoryReader::HistoryReader(const char* filename) : file_(filename, std::ios::binary) {
+  open_ = false;
+  lastGeneration_ = 0;
+  if (!file_.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return;
+  }
+  char magic[8];
+  std::uint32_t keyframeInterval;
+  if (!file_.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+      !getRaw(file_, keyframeInterval)) {
+    std::cerr << "Error: " << filename << " no es un historial válido." << std::endl;
+    return;
+  }
+
+  // Leer el índice del final; si no está, el fichero no se cerró y se recorre entero
+  std::uint64_t indexOffset = 0;
+  char indexMagic[8];
+  file_.seekg(-static_cast<std::streamoff>(sizeof(indexOffset) + sizeof(indexMagic)), std::ios::end);
+  if (getRaw(file_, indexOffset) && file_.read(indexMagic, sizeof(indexMagic)) &&
+      std::memcmp(indexMagic, kIndexMagic, sizeof(indexMagic)) == 0) {
+    file_.seekg(indexOffset);
+    std::uint8_t type;
+    std::uint64_t last, count;
+    if (getRaw(file_, type) && type == kIndex && getRaw(file_, last) && getRaw(file_, count)) {
+      index_.resize(count);
+      for (auto& entry : index_) {
+        getRaw(file_, entry.first);
+        getRaw(file_, entry.second);
+      }
+      lastGeneration_ = last;
+      open_ = static_cast<bool>(file_) && !index_.empty();
+    }
+  }
+  if (!open_) {
+    file_.clear();
+    open_ = scanRecords();
+  }
+}
+
+// Reconstruir el índice saltando de registro en registro
+bool HistoryReader::scanRecords() {
+  index_.clear();
+  file_.seekg(0, std::ios::end);
+  const std::uint64_t size = file_.tellg();
+  file_.seekg(sizeof(kMagic) + sizeof(std::uint32_t));
+  while (true) {
+    const std::uint64_t offset = file_.tellg();
+    std::uint8_t type;
+    std::uint64_t generation, bytes;
+    std::uint32_t rows, cols;
+    if (!getRaw(file_, type) || type == kIndex || !getRaw(file_, generation) || !getRaw(file_, rows) ||
+        !getRaw(file_, cols) || !getRaw(file_, bytes)) {
+      break;
+    }
+    // un registro cortado a medias (escritura interrumpida) marca el final
+    const std::uint64_t end = static_cast<std::uint64_t>(file_.tellg()) + bytes;
+    if (end > size) {
+      break;
+    }
+    file_.seekg(end);
+    if (type == kKeyframe) {
+      index_.push_back(std::make_pair(generation, offset));
+    }
+    lastGeneration_ = generation;
+  }
+  file_.clear();
+  return !index_.empty();
+}
+
+bool HistoryReader::isOpen() const {
+  return open_;
+}
+
+std::size_t HistoryReader::firstGeneration() const {
+  return index_.empty() ? 0 : index_.front().first;
+}
+
+std::size_t HistoryReader::lastGeneration() const {
+  return lastGeneration_;
+}
+
+// Un registro cuyo contenido no cuadra con su cabecera: la búsqueda falla
+static bool corrupt(std::uint64_t generation) {
+  std::cerr << "Error: El registro de la generación " << generation << " del historial está dañado." << std::endl;
+  return false;
+}
+
+bool HistoryReader::seek(std::size_t generation, Bitboard& board) {
+  if (!open_ || generation < firstGeneration() || generation > lastGeneration_) {
+    return false;
+  }
+  // último fotograma completo que no pasa de la generación pedida
+  auto keyframe = std::upper_bound(index_.begin(), index_.end(), std::make_pair(generation, ~std::uint64_t(0)));
+  --keyframe;
+
+  file_.clear();
+  file_.seekg(0, std::ios::end);
+  const std::uint64_t size = file_.tellg();
+  file_.seekg(keyframe->second);
+  bool loaded = false;
+  while (true) {
+    std::uint8_t type;
+    std::uint64_t recordGeneration, bytes;
+    std::uint32_t rows, cols;
+    if (!getRaw(file_, type) || type == kIndex || !getRaw(file_, recordGeneration) || !getRaw(file_, rows) ||
+        !getRaw(file_, cols) || !getRaw(file_, bytes)) {
+      return false;
+    }
+    if (bytes > size - static_cast<std::uint64_t>(file_.tellg())) {
+      return corrupt(recordGeneration);
+    }
+    std::vector<char> payload(bytes);
+    if (!file_.read(payload.data(), bytes)) {
+      return false;
+    }
+    const char* p = payload.data();
+    const char* end = payload.data() + payload.size();
+
+    if (type == kKeyframe) {
+      board = Bitboard(rows, cols);
+      const std::size_t rowBytes = board.getWords() * sizeof(std::uint64_t);
+      if (bytes != rows * rowBytes) {
+        return corrupt(recordGeneration);
+      }
+      for (std::uint32_t i = 0; i < rows; ++i) {
+        std::memcpy(board.row(i) + 1, p, rowBytes);
+        p += rowBytes;
+      }
+      loaded = true;
+    } else if (loaded) {
+      // aplicar las rachas del delta; cada racha se comprueba antes de escribir
+      // para que un fichero dañado no escriba fuera del tablero
+      if (rows != static_cast<std::uint32_t>(board.getRows()) || cols != static_cast<std::uint32_t>(board.getCols())) {
+        return corrupt(recordGeneration);
+      }
+      const std::uint64_t words = board.getWords();
+      const std::uint64_t total = static_cast<std::uint64_t>(rows) * words;
+      std::uint64_t position = 0;
+      while (p < end) {
+        std::uint32_t zeros, literals;
+        if (static_cast<std::size_t>(end - p) < sizeof(zeros) + sizeof(literals)) {
+          return corrupt(recordGeneration);
+        }
+        std::memcpy(&zeros, p, sizeof(zeros));
+        std::memcpy(&literals, p + sizeof(zeros), sizeof(literals));
+        p += sizeof(zeros) + sizeof(literals);
+        position += zeros;
+        if (position + literals > total ||
+            static_cast<std::uint64_t>(end - p) < static_cast<std::uint64_t>(literals) * sizeof(std::uint64_t)) {
+          return corrupt(recordGeneration);
+        }
+        for (std::uint32_t l = 0; l < literals; ++l, ++position) {
+          std::uint64_t change;
+          std::memcpy(&change, p, sizeof(change));
+          p += sizeof(change);
+          board.row(static_cast<int>(position / words))[position % words + 1] ^= change;
+        }
+      }
+    }
+    if (recordGeneration == generation) {
+      return loaded;
+    }
+  }
+}
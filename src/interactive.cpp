@@ -0,0 +1,357 @@
+#include "interactive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Límites del ritmo objetivo, en generaciones por segundo
+static const double kMinRate = 0.25;
+static const double kMaxRate = 4096.0;
+// Cada cuánto se despierta la interfaz si no llega ninguna tecla (~30 fps)
+static const int kFrameMillis = 33;
+
+// Terminal sin eco ni búfer de línea mientras dura el objeto
+class RawTerminal {
+public:
+  RawTerminal() {
+    active_ = tcgetattr(STDIN_FILENO, &saved_) == 0;
+    if (active_) {
+      termios raw = saved_;
+      raw.c_lflag &= ~(ICANON | ECHO);
+      raw.c_cc[VMIN] = 0;
+      raw.c_cc[VTIME] = 0;
+      tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+  }
+
+  ~RawTerminal() {
+    if (active_) {
+      tcsetattr(STDIN_FILENO, TCSANOW, &saved_);
+    }
+  }
+
+private:
+  termios saved_;
+  bool active_;
+};
+
+static void writeString(const std::string& text) {
+  std::size_t written = 0;
+  while (written < text.size()) {
+    ssize_t n = write(STDOUT_FILENO, text.data() + written, text.size() - written);
+    if (n <= 0) {
+      return;
+    }
+    written += n;
+  }
+}
+
+InteractiveSession::InteractiveSession(Lattice& lattice, double rate) : lattice_(lattice) {
+  paused_ = false;
+  pendingSteps_ = 0;
+  rate_ = rate > 0 ? std::min(std::max(rate, kMinRate), kMaxRate) : 0;
+  quit_ = false;
+  frameReady_ = false;
+  frameWanted_ = true;
+  lastPublished_ = 0;
+  popMode_ = lattice.getPopMode();
+  fitted_ = false;
+  viewRows_ = 21;
+  viewCols_ = 80;
+}
+
+// Copia la generación actual en el fotograma del simulador y la entrega a la
+// interfaz, solo si esta ya dibujó la anterior: sin límite de ritmo el
+// simulador no copia el tablero en cada generación. La generación que se salta
+// así se entrega cuando la interfaz pide el siguiente fotograma
+void InteractiveSession::publishFrame() {
+  {
+    std::lock_guard<std::mutex> lock(frameMutex_);
+    if (!frameWanted_) {
+      return;
+    }
+  }
+  back_.board = lattice_.getBoard();
+  back_.generation = lattice_.getGeneration();
+  back_.population = lattice_.Population();
+
+  std::lock_guard<std::mutex> lock(frameMutex_);
+  std::swap(back_, front_);
+  frameReady_ = true;
+  frameWanted_ = false;
+  lastPublished_ = front_.generation;
+}
+
+// La interfaz espera un fotograma y el tablero ya va por otra generación
+bool InteractiveSession::frameOutdated() {
+  std::lock_guard<std::mutex> lock(frameMutex_);
+  return frameWanted_ && lattice_.getGeneration() != lastPublished_;
+}
+
+void InteractiveSession::simulationLoop() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point deadline = Clock::now();
+  publishFrame();
+
+  while (true) {
+    std::vector<std::string> saves;
+    bool doStep = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // esperar a que haya algo que hacer: una orden o, en marcha, el siguiente plazo
+      while (!quit_ && pendingSaves_.empty() && pendingSteps_ == 0 && !frameOutdated()) {
+        if (paused_) {
+          wake_.wait(lock);
+        } else if (rate_ > 0 && Clock::now() < deadline) {
+          wake_.wait_until(lock, deadline);
+        } else {
+          break;
+        }
+      }
+      if (quit_) {
+        return;
+      }
+      saves.swap(pendingSaves_);
+      if (pendingSteps_ > 0) {
+        --pendingSteps_;
+        doStep = true;
+      } else if (!paused_ && (rate_ == 0 || Clock::now() >= deadline)) {
+        doStep = true;
+        if (rate_ > 0) {
+          // sin acumular retraso si una generación tarda más que el plazo
+          const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate_));
+          deadline = std::max(deadline + period, Clock::now());
+        }
+      }
+    }
+
+    // límite de generación: primero las órdenes, después el cálculo
+    for (const std::string& path : saves) {
+      lattice_.saveToFile(path.c_str());
+      std::lock_guard<std::mutex> lock(mutex_);
+      message_ = "Generación " + std::to_string(lattice_.getGeneration()) + " guardada en " + path;
+    }
+    if (doStep) {
+      lattice_.step();
+    }
+    publishFrame();
+  }
+}
+
+void InteractiveSession::draw(const Frame& frame) {
+  struct winsize size;
+  int termRows = 24;
+  int termCols = 80;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+    termRows = size.ws_row;
+    termCols = size.ws_col;
+  }
+  viewRows_ = std::max(termRows - 3, 1);
+  viewCols_ = termCols;
+  // un tablero que no cabe empieza viéndose entero
+  if (!fitted_ && frame.board.getRows() > 0) {
+    view_.zoom = fitZoom(frame.board.getRows(), frame.board.getCols(), viewRows_, viewCols_);
+    fitted_ = true;
+  }
+
+  std::ostringstream status;
+  std::string message;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status << "Generación " << frame.generation << "  Células vivas: " << frame.population
+           << "  Ventana (" << view_.row << ", " << view_.col << ") 1:" << view_.zoom << "  ";
+    if (paused_) {
+      status << "[pausa]";
+    } else if (rate_ > 0) {
+      status << "[" << rate_ << " gen/s]";
+    } else {
+      status << "[sin límite]";
+    }
+    message = message_;
+  }
+
+  // Se compone el fotograma entero y se escribe de una vez
+  std::string out = "\x1b[H" + status.str().substr(0, termCols) + "\x1b[K\r\n";
+  out += "espacio: pausa  n: paso  +/-: ritmo  f: sin límite  c: población  s: guardar  x: salir  "
+         "hjkl/flechas: mover  i/o: zoom  0: todo\x1b[K\r\n";
+  if (!popMode_) {
+    renderViewport(frame.board, view_, viewRows_, viewCols_, out, "\x1b[K\r\n");
+  }
+  out += message.substr(0, termCols);
+  out += "\x1b[K\x1b[J";
+  writeString(out);
+}
+
+// Pedir el nombre del fichero con el terminal en modo normal. El simulador sigue
+// calculando mientras tanto
+std::string InteractiveSession::askFileName() {
+  termios raw;
+  tcgetattr(STDIN_FILENO, &raw);
+  termios cooked = raw;
+  cooked.c_lflag |= ICANON | ECHO;
+  tcsetattr(STDIN_FILENO, TCSANOW, &cooked);
+
+  writeString("\x1b[?25h\r\nEscriba el nombre del archivo de salida: ");
+  std::string name;
+  std::getline(std::cin, name);
+  writeString("\x1b[?25l");
+
+  tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  return name;
+}
+
+// Teclas de la ventana: mover un cuarto de pantalla, acercar, alejar o ver todo.
+// Devuelve false si la tecla no es de la ventana
+bool InteractiveSession::handleViewKey(char key) {
+  const int rows = display_.board.getRows();
+  const int cols = display_.board.getCols();
+  switch (key) {
+  case 'h':
+    view_.col -= std::max(viewCols_ / 4, 1) * view_.zoom;
+    break;
+  case 'l':
+    view_.col += std::max(viewCols_ / 4, 1) * view_.zoom;
+    break;
+  case 'k':
+    view_.row -= std::max(viewRows_ / 4, 1) * view_.zoom;
+    break;
+  case 'j':
+    view_.row += std::max(viewRows_ / 4, 1) * view_.zoom;
+    break;
+  case 'i':
+  case 'o': {
+    // el centro de la ventana se queda en su sitio
+    const int centerRow = view_.row + viewRows_ * view_.zoom / 2;
+    const int centerCol = view_.col + viewCols_ * view_.zoom / 2;
+    // alejar más allá de ver el tablero entero no aporta nada
+    const int widest = fitZoom(rows, cols, viewRows_, viewCols_);
+    view_.zoom = key == 'i' ? std::max(view_.zoom / 2, 1) : std::min(view_.zoom * 2, std::max(widest, view_.zoom));
+    view_.row = centerRow - viewRows_ * view_.zoom / 2;
+    view_.col = centerCol - viewCols_ * view_.zoom / 2;
+    break;
+  }
+  case '0':
+    view_ = Viewport();
+    view_.zoom = fitZoom(rows, cols, viewRows_, viewCols_);
+    break;
+  default:
+    return false;
+  }
+  // la ventana no se sale del tablero
+  view_.row = std::max(0, std::min(view_.row, rows - viewRows_ * view_.zoom));
+  view_.col = std::max(0, std::min(view_.col, cols - viewCols_ * view_.zoom));
+  return true;
+}
+
+// Devuelve false para salir
+bool InteractiveSession::handleKey(char key) {
+  if (handleViewKey(key)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  switch (key) {
+  case ' ':
+    paused_ = !paused_;
+    break;
+  case 'n':
+    // paso a paso: una generación más y queda en pausa
+    ++pendingSteps_;
+    paused_ = true;
+    break;
+  case '+':
+    rate_ = rate_ > 0 ? std::min(rate_ * 2, kMaxRate) : rate_;
+    break;
+  case '-':
+    rate_ = rate_ > 0 ? std::max(rate_ / 2, kMinRate) : kMaxRate;
+    break;
+  case 'f':
+    rate_ = rate_ > 0 ? 0 : 10;
+    break;
+  case 'c':
+    popMode_ = !popMode_;
+    break;
+  case 'x':
+  case 'q':
+    quit_ = true;
+    break;
+  default:
+    return true;
+  }
+  wake_.notify_one();
+  return !quit_;
+}
+
+int InteractiveSession::run() {
+  RawTerminal terminal;
+  writeString("\x1b[?1049h\x1b[?25l\x1b[2J"); // pantalla alternativa, sin cursor
+  std::thread simulator(&InteractiveSession::simulationLoop, this);
+
+  bool running = true;
+  bool redraw = true;
+  while (running) {
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&input, 1, kFrameMillis) > 0) {
+      char keys[32];
+      ssize_t n = read(STDIN_FILENO, keys, sizeof(keys));
+      for (ssize_t k = 0; k < n && running; ++k) {
+        // las flechas llegan como ESC [ A..D
+        if (keys[k] == '\x1b' && k + 2 < n && keys[k + 1] == '[') {
+          const char arrow = keys[k + 2];
+          k += 2;
+          keys[k] = arrow == 'A' ? 'k' : arrow == 'B' ? 'j' : arrow == 'C' ? 'l' : arrow == 'D' ? 'h' : 0;
+        }
+        if (keys[k] == 's') {
+          const std::string name = askFileName();
+          if (!name.empty()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pendingSaves_.push_back(name);
+            wake_.notify_one();
+          }
+        } else {
+          running = handleKey(keys[k]);
+        }
+        redraw = true;
+      }
+      if (n == 0) {
+        running = false; // fin de la entrada
+      }
+    }
+
+    bool taken = false;
+    {
+      std::lock_guard<std::mutex> lock(frameMutex_);
+      if (frameReady_) {
+        std::swap(front_, display_);
+        frameReady_ = false;
+        frameWanted_ = true;
+        redraw = true;
+        taken = true;
+      }
+    }
+    if (taken) {
+      // si el simulador se paró después de saltarse una generación, que la entregue
+      std::lock_guard<std::mutex> lock(mutex_);
+      wake_.notify_one();
+    }
+    if (redraw && running) {
+      draw(display_);
+      redraw = false;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+    wake_.notify_one();
+  }
+  writeString("\x1b[?25h\x1b[?1049l");
+  // si hay una generación a medias, se termina antes de salir
+  simulator.join();
+  return 0;
+}
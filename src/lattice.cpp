@@ -1,4 +1,9 @@
 #include "lattice.h"
+#include "soup.h"
+#include "history.h"
+#include "framestream.h"
+#include "viewport.h"
+#include "textboard.h"
 #include <fstream>
 
 // Implementación del constructor de Lattice
@@ -7,58 +12,92 @@ Lattice::Lattice(int N, int M) {
   rows = N;
   cols = M;
   popMode = false;
-
-  // Crear las células en memoria dinámica y establecer su estado inicial a "muerta" (false)
-  for (int i = 0; i < N; ++i) {
-    std::vector<Cell*> row;
-    for (int j = 0; j < M; ++j) {
-      row.push_back(new Cell(std::make_pair(i, j), false));
-    }
-    cells_.push_back(row);
-  }
+  generation_ = 0;
+  frontera_ = Frontera::abiertaFria;
+  history_ = nullptr;
+  frames_ = nullptr;
+  stats_ = nullptr;
+  setEngine(EngineKind::scalar, Rule());
+
+  // Crear las células y establecer su estado inicial a "muerta" (false),
+  // incluido el halo que rodea al retículo
+  board_ = Bitboard(N, M);
+  next_ = Bitboard(N, M);
 
   // Solicitar por teclado las posiciones de las células vivas en la configuración inicial
   askForLiveCells();
 }
 
-// Constructor por archivo
-Lattice::Lattice(const char* filename) {
+// Constructor con sopa aleatoria: no pregunta por teclado
+Lattice::Lattice(int N, int M, std::uint64_t seed, double density) {
 
+  rows = N;
+  cols = M;
   popMode = false;
+  generation_ = 0;
+  frontera_ = Frontera::abiertaFria;
+  history_ = nullptr;
+  frames_ = nullptr;
+  stats_ = nullptr;
+  setEngine(EngineKind::scalar, Rule());
+
+  board_ = Bitboard(N, M);
+  next_ = Bitboard(N, M);
+  randomSoup(seed, density, 0, 0, N, M);
+}
 
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
-    return;
-  }
-
-  // Leer las dimensiones de la retícula del archivo
-  file >> rows >> cols;
-  file.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Ignorar el resto de la línea para mover el puntero al inicio de la próxima línea
-
-  // Reservar espacio para las células
-  cells_.resize(rows, std::vector<Cell*>(cols));
+// Constructor a partir de un tablero empaquetado
+Lattice::Lattice(const Bitboard& board, std::size_t generation) {
 
-  // Leer las cadenas de caracteres del archivo para inicializar las células
-  for (int i = 0; i < rows; ++i) {
-    std::string rowString;
-    std::getline(file, rowString); // Leer la línea completa, incluidos los espacios en blanco
+  rows = board.getRows();
+  cols = board.getCols();
+  popMode = false;
+  generation_ = generation;
+  frontera_ = Frontera::abiertaFria;
+  history_ = nullptr;
+  frames_ = nullptr;
+  stats_ = nullptr;
+  setEngine(EngineKind::scalar, Rule());
+
+  board_ = board;
+  next_ = Bitboard(rows, cols);
+}
 
-    // Verificar que la longitud de la cadena sea igual al número de columnas
-    if (rowString.length() != cols) {
-      std::cerr << "Error: La longitud de la fila no coincide con el número de columnas especificado." << std::endl;
-      return;
-    }
+// Constructor por archivo
+Lattice::Lattice(const char* filename) {
 
-    for (int j = 0; j < cols; ++j) {
-      // Crear una célula viva si el carácter es 'X', de lo contrario, crear una célula muerta
-      bool isAlive = (rowString[j] == 'X');
-      cells_[i][j] = new Cell(std::make_pair(i, j), isAlive);
-    }
+  rows = 0;
+  cols = 0;
+  popMode = false;
+  generation_ = 0;
+  frontera_ = Frontera::abiertaFria;
+  history_ = nullptr;
+  frames_ = nullptr;
+  stats_ = nullptr;
+  setEngine(EngineKind::scalar, Rule());
+
+  // El fichero se proyecta en memoria y las filas se empaquetan en paralelo
+  TextBoard text(filename);
+  if (!text.isOpen()) {
+    loadError_ = text.getError();
+    return;
+  }
+  rows = text.getRows();
+  cols = text.getCols();
+
+  // Reservar espacio para las células, halo incluido, inicialmente muertas
+  board_ = Bitboard(rows, cols);
+  next_ = Bitboard(rows, cols);
+
+  // Un fichero con filas incorrectas no se carga a medias: el retículo queda
+  // vacío y getLoadError() explica por qué
+  if (!text.pack(board_)) {
+    loadError_ = text.getError();
+    rows = 0;
+    cols = 0;
+    board_ = Bitboard(0, 0);
+    next_ = Bitboard(0, 0);
   }
-
-  // Cerrar el archivo
-  file.close();
 }
 
 Lattice::Lattice(int once) {
@@ -66,17 +105,19 @@ Lattice::Lattice(int once) {
   rows = 1;
   cols = 1;
   popMode = false;
+  generation_ = 0;
+  frontera_ = Frontera::abiertaFria;
+  history_ = nullptr;
+  frames_ = nullptr;
+  stats_ = nullptr;
+  setEngine(EngineKind::scalar, Rule());
+  board_ = Bitboard(rows, cols);
+  next_ = Bitboard(rows, cols);
 
 }
 
-// Destructor de Lattice
+// Destructor de Lattice: las células están empaquetadas en board_, que libera su memoria
 Lattice::~Lattice() {
-  // Liberar la memoria de las células
-  for (auto& row : cells_) {
-    for (auto& cell : row) {
-      delete cell;
-    }
-  }
 }
 
 int Lattice::getRows() const {
@@ -88,12 +129,12 @@ int Lattice::getCols() const {
 }
 
 // getter frontera
-std::string Lattice::getFrontera() const {
+Frontera Lattice::getFrontera() const {
     return frontera_;
 }
 
 // setter frontera
-void Lattice::setFrontera(const std::string& frontera) {
+void Lattice::setFrontera(Frontera frontera) {
     frontera_ = frontera;
 }
 
@@ -121,7 +162,7 @@ void Lattice::askForLiveCells() {
 
     if (row >= 0 && row < rows && col >= 0 && col < cols) {
       // Establecer el estado de la célula en vivo (true)
-      cells_[row][col]->setState(true);
+      board_.set(row, col, true);
     } else {
       std::cout << "Posición inválida. Por favor, ingrese una posición dentro del retículo." << std::endl;
     }
@@ -142,345 +183,246 @@ void Lattice::askForLiveCells() {
   }
 }
 
+// Sopa aleatoria sobre el tablero empaquetado, reproducible para una semilla dada
+void Lattice::randomSoup(std::uint64_t seed, double density, int rowBegin, int colBegin, int rowEnd, int colEnd,
+                         int threads) {
+  ::randomSoup(board_, seed, density, rowBegin, colBegin, rowEnd, colEnd, threads);
+  if (stats_ != nullptr)
+  {
+    stats_->editRect(board_, rowBegin, colBegin, rowEnd, colEnd);
+  }
+  edited_ = true;
+}
+
 // Implementación del método para calcular la población actual (número de células vivas)
 std::size_t Lattice::Population() const {
-  std::size_t aliveCount = 0;
-  for (const auto& row : cells_) {
-    for (const auto& cell : row) {
-      if (cell->getState()) { // Si el estado de la célula es verdadero (viva)
-        ++aliveCount;
-      }
-    }
-  }
-  return aliveCount;
+  // El halo no forma parte de la población
+  return board_.population();
 }
 
-// Sobrecarga del operador [] para acceder a las células por su posición en el retículo
-Cell& Lattice::operator[](const Position& pos) const {
-  // Obtener las coordenadas de la posición
-  int x = pos.first;
-  int y = pos.second;
+std::size_t Lattice::getGeneration() const {
+  return generation_;
+}
 
-  // Verificar que las coordenadas estén dentro de los límites del retículo
-  if (x >= 0 && x < rows && y >= 0 && y < cols) {
-    // Devolver la referencia a la célula en la posición dada
-    return *cells_[x][y];
-  } else {
-    // Si las coordenadas están fuera de los límites, lanzar una excepción o devolver una referencia nula
-    // Aquí se elige lanzar una excepción
-    throw std::out_of_range("Posición fuera de los límites del retículo.");
-  }
+const Bitboard& Lattice::getBoard() const {
+  return board_;
 }
 
-// Metodo para actualizar las posiciones
-void Lattice::updatePositions() {
-  for (int i = 0; i < rows; ++i) {
-    for (int j = 0; j < cols; ++j) {
-      this->cells_[i][j]->setPosition(i,j);
-    }
-  }
+const std::string& Lattice::getLoadError() const {
+  return loadError_;
 }
 
-void Lattice::updateStates() {
-  for (int i = 0; i < rows; i++)
-  {
-    for (int j = 0; j < cols; j++)
-    {
-      this->cells_[i][j]->updateState();
-    }
-  }
+void Lattice::setHistory(HistoryWriter* history) {
+  history_ = history;
 }
 
-// Condicion abierta, temp es si caliente o fria (true o false)
-void Lattice::openFrontier(const bool temp) {
-  Position pos(0,0);
-  // Añadir columnas a los lados con células en el estado dado
-  for (int i = 0; i < rows; ++i) {
-    Cell* auxCell1 = new Cell(pos, temp);
-    Cell* auxCell2 = new Cell(pos, temp);
-    // Izquierda
-    cells_[i].insert(cells_[i].begin(), auxCell1);
-    // Derecha
-    cells_[i].push_back(auxCell2);
-  }
-  cols += 2; // Se añaden dos columnas nuevas
+void Lattice::setFrameStream(FrameStream* frames) {
+  frames_ = frames;
+}
 
-  // Añadir filas arriba y abajo con células en el estado dado
-  // Fila arriba
-  std::vector<Cell*> upRow;
-  for (int i = 0; i < cols; i++)
+void Lattice::setEngine(EngineKind kind, const Rule& rule, int sampleInterval) {
+  rule_ = rule;
+  sampleInterval_ = std::max(sampleInterval, 1);
+  lastBoxArea_ = 0;
+  edited_ = true;
+  if (kind == EngineKind::adaptive)
   {
-    upRow.push_back(new Cell(std::make_pair(0,0), temp));
-  }
-  cells_.insert(cells_.begin(), upRow);
-  
-  // Fila abajo
-  std::vector<Cell*> downRow;
-  for (int i = 0; i < cols; i++)
+    policy_.reset(new EnginePolicy(rule));
+    // se empieza por el más rápido en tableros activos que admite la regla
+    engine_ = makeEngine(rule.isConway() ? EngineKind::bitSliced : EngineKind::lut, rule);
+  } else
   {
-    downRow.push_back(new Cell(std::make_pair(0,0), temp));
+    policy_.reset();
+    engine_ = makeEngine(kind, rule);
   }
-  cells_.push_back(downRow);
-  rows += 2; // Se añaden dos filas nuevas
-
-  // Ajustar las posiciones de las células existentes
-  this->updatePositions();
-
 }
 
-// Condicion de frontera periodica
-void Lattice::periodicFrontier() {
-  // Expansión de la frontera periódica
-  std::vector<std::vector<Cell*>> tempCells = cells_; // Variable temporal para almacenar las células originales
+EngineKind Lattice::getEngine() const {
+  return engine_->kind();
+}
 
-  // Expansión hacia los lados
-  for (int i = 0; i < rows; ++i) {
-    // Izquierda
-    cells_[i].insert(cells_[i].begin(), new Cell(std::make_pair(0,0), tempCells[i][cols - 1]->getState()));
-    // Derecha
-    cells_[i].push_back(new Cell(std::make_pair(0,0),tempCells[i][0]->getState()));
-  }
+void Lattice::setStats(CellStats* stats) {
+  stats_ = stats;
+}
 
-  std::vector<Cell*> upRow;
-  for (int i = 0; i < cols; i++)
+// Estampar un patrón con su esquina superior izquierda en (row, col)
+void Lattice::stamp(const Bitboard& pattern, int row, int col, StampMode mode) {
+  board_.stamp(pattern, row, col, mode);
+  if (stats_ != nullptr)
   {
-    upRow.push_back(new Cell(std::make_pair(0,0), tempCells[0][i]->getState()));
+    stats_->editRect(board_, row, col, row + pattern.getRows(), col + pattern.getCols());
   }
-  cells_.insert(cells_.begin(), upRow);
-  
-  // Fila abajo
-  std::vector<Cell*> downRow;
-  for (int i = 0; i < cols; i++)
+  edited_ = true;
+}
+
+// Rellenar (state = true) o vaciar (state = false) un rectángulo
+void Lattice::fillRect(int rowBegin, int colBegin, int rowEnd, int colEnd, State state) {
+  board_.fillRect(rowBegin, colBegin, rowEnd, colEnd, state);
+  if (stats_ != nullptr)
   {
-    downRow.push_back(new Cell(std::make_pair(0,0), tempCells[rows - 1][i]->getState()));
+    stats_->editRect(board_, rowBegin, colBegin, rowEnd, colEnd);
   }
-  cells_.push_back(downRow);
-
-  // Esquinas
-  // arriba izquierda
-  cells_[0].insert(cells_[0].begin(), new Cell(std::make_pair(0,0), tempCells[rows - 1][cols - 1]->getState()));
-  // arriba derecha
-  cells_[0].push_back(new Cell(std::make_pair(0,0), tempCells[rows - 1][0]->getState()));
-  
-  rows += 2;
-  // abajo derecha
-  cells_[rows - 1].push_back(new Cell(std::make_pair(0,0), tempCells[0][0]->getState()));
-  // abajo izquierda
-  cells_[rows - 1].insert(cells_[rows - 1].begin(), new Cell(std::make_pair(0,0), tempCells[0][cols - 1]->getState()));
-
-  cols += 2;
-
-  // Ajustar las posiciones de las células existentes
-  this->updatePositions();
+  edited_ = true;
 }
 
-// Expand lattice para sin frontera
-void Lattice::noFrontier(int row, int col) {
-
-  // Expandir el retículo creando una nueva fila o columna con células muertas en la dirección correspondiente
-  
-  // Esquinas
-  if (row == 0 && col == 0) {
-    // Esquina superior izquierda
-    // Insertar una nueva columna en el lado izquierdo
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].insert(cells_[i].begin(), new Cell(std::make_pair(i, 0), false)); // Agregar al principio
-    }
-    ++cols;
-
-    // Insertar una nueva fila en la parte superior
-    cells_.insert(cells_.begin(), std::vector<Cell*>(cols, new Cell(std::make_pair(rows, cols), false))); // Agregar al principio
-    ++rows;
-
-    // Ajustar las posiciones de todas las células existentes en las columnas
-    this->updatePositions();
-
-  } else if (row == 0 && col == cols - 1) {
-    // Esquina superior derecha
-    // Columna por la parte derecha
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].push_back(new Cell(std::make_pair(0, 0), false)); // Agregar al final
-    }
-    ++cols;
-
-    // Insertar una nueva fila en la parte superior
-    cells_.insert(cells_.begin(), std::vector<Cell*>(cols, new Cell(std::make_pair(rows, cols), false))); // Agregar al principio
-    ++rows;
+void Lattice::queueStamp(std::size_t generation, const Bitboard& pattern, int row, int col, StampMode mode) {
+  pendingEdits_.push_back(Edit{generation, true, pattern, row, col, 0, 0, mode, false});
+}
 
-    // Ajustar las posiciones de todas las células existentes en las filas
-    this->updatePositions();
+void Lattice::queueFillRect(std::size_t generation, int rowBegin, int colBegin, int rowEnd, int colEnd, State state) {
+  pendingEdits_.push_back(Edit{generation, false, Bitboard(), rowBegin, colBegin, rowEnd, colEnd,
+                               StampMode::overwrite, state});
+}
 
-  } else if (row == rows - 1 && col == 0) {
-    // Esquina inferior izquierda
-    // Insertar una nueva columna en el lado izquierdo
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].insert(cells_[i].begin(), new Cell(std::make_pair(i, 0), false)); // Agregar al principio
+// Aplicar, en el orden en que se encolaron, las ediciones de generaciones ya alcanzadas
+void Lattice::applyPendingEdits() {
+  std::vector<Edit> later;
+  for (const Edit& edit : pendingEdits_) {
+    if (edit.generation > generation_) {
+      later.push_back(edit);
+    } else if (edit.isStamp) {
+      stamp(edit.pattern, edit.row, edit.col, edit.mode);
+    } else {
+      fillRect(edit.row, edit.col, edit.rowEnd, edit.colEnd, edit.state);
     }
-    ++cols;
-    
-    // Insertar una nueva fila en la parte inferior
-    cells_.push_back(std::vector<Cell*>(cols, new Cell(std::make_pair(rows, 0), false)));
-    ++rows;
+  }
+  pendingEdits_.swap(later);
+}
 
-    // Ajustar las posiciones de todas las células existentes en las columnas
-    this->updatePositions();
+// Sobrecarga del operador [] para acceder a las células por su posición en el retículo
+Cell Lattice::operator[](const Position& pos) const {
+  // Obtener las coordenadas de la posición
+  int x = pos.first;
+  int y = pos.second;
 
-  } else if (row == rows - 1 && col == cols - 1) {
-    // Esquina inferior derecha
+  // Verificar que las coordenadas estén dentro de los límites del retículo
+  if (x >= 0 && x < rows && y >= 0 && y < cols) {
+    // Devolver la célula en la posición dada
+    return Cell(pos, board_.get(x, y));
+  } else {
+    // Si las coordenadas están fuera de los límites, lanzar una excepción o devolver una referencia nula
+    // Aquí se elige lanzar una excepción
+    throw std::out_of_range("Posición fuera de los límites del retículo.");
+  }
+}
 
-    // Columna por la parte derecha
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].push_back(new Cell(std::make_pair(0, 0), false)); // Agregar al final
-    }
-    ++cols;
+// Acceso a las células incluyendo el halo (filas -1 y rows, columnas -1 y cols)
+Cell Lattice::haloAt(int row, int col) const {
+  if (row >= -1 && row <= rows && col >= -1 && col <= cols) {
+    return Cell(std::make_pair(row, col), board_.get(row, col));
+  } else {
+    throw std::out_of_range("Posición fuera de los límites del halo del retículo.");
+  }
+}
 
-    // fila parte inferior
-    cells_.push_back(std::vector<Cell*>(cols, new Cell(std::make_pair(rows, cols), false)));
-    ++rows;
+// Pasar a la siguiente generación ya calculada en next_
+void Lattice::updateStates() {
+  board_.swap(next_);
+}
 
-    // Actualizar posiciones
-    this->updatePositions();
+// Rellenar el halo en su sitio según la frontera. Las fronteras abiertas copian
+// una fila constante y la periódica copia las filas y columnas del lado opuesto
+void Lattice::fillHalo() {
+  board_.fillHalo(frontera_);
+}
 
+// Sin frontera: si hay células vivas en un borde, el retículo crece una fila o
+// columna muerta por ese lado
+void Lattice::growBorders() {
+  bool up = false, down = false, left = false, right = false;
+  for (int j = 0; j < cols; ++j) {
+    up = up || board_.get(0, j);
+    down = down || board_.get(rows - 1, j);
+  }
+  for (int i = 0; i < rows; ++i) {
+    left = left || board_.get(i, 0);
+    right = right || board_.get(i, cols - 1);
   }
-  else if (row == 0) {
-    // Expansión hacia arriba
-    // Insertar una nueva fila de células muertas en la parte superior
-    cells_.insert(cells_.begin(), std::vector<Cell*>(cols, new Cell(std::make_pair(0, 0), false)));
-    ++rows;
-
-    // Ajustar las posiciones de todas las células existentes en las filas
-    this->updatePositions();
-
-  } else if (row == rows - 1) {
-    // Expansión hacia abajo
-    // Insertar una nueva fila de células muertas en la parte inferior
-    cells_.push_back(std::vector<Cell*>(cols, new Cell(std::make_pair(rows, 0), false)));
-    ++rows;
-    
-    // Actualizar posicion
-    this->updatePositions();
-
-  } 
-  else if (col == 0) {
-    // Expansión hacia la izquierda
-    // Insertar una nueva columna de células muertas en el lado izquierdo
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].insert(cells_[i].begin(), new Cell(std::make_pair(i, 0), false)); // Agregar al principio
-    }
-    ++cols;
-
-    // Ajustar las posiciones de todas las células existentes en las columnas
-    this->updatePositions();
 
-  } else if (col == cols - 1) {
-    // Expansión hacia la derecha
-    // Insertar una nueva columna de células muertas en el lado derecho
-    for (int i = 0; i < rows; ++i) {
-      cells_[i].push_back(new Cell(std::make_pair(i, cols), false)); // Agregar al final
+  if (up || down || left || right) {
+    board_.grow(up, left, down, right);
+    if (stats_ != nullptr)
+    {
+      stats_->grow(up, left, down, right);
     }
-    ++cols;
-
-    this->updatePositions();
-
+    rows = board_.getRows();
+    cols = board_.getCols();
+    next_ = Bitboard(rows, cols);
+    edited_ = true;
   }
 }
 
-// Restaurar tamaño original, para print
-void Lattice::removeBorders() {
-  // Eliminar las columnas adicionales en los lados
-  for (int i = 0; i < rows; ++i) {
-    cells_[i].erase(cells_[i].begin()); // Eliminar la primera célula en la fila (lado izquierdo)
-    cells_[i].pop_back(); // Eliminar la última célula en la fila (lado derecho)
-  }
-  cols -= 2; // Se eliminan dos columnas
+// Calculo de la siguiente generación. El núcleo recorre siempre el interior;
+// de la frontera se encarga únicamente el halo
+void Lattice::step() {
+  this->fillHalo();
 
-  // Eliminar las filas adicionales arriba y abajo
-  cells_.erase(cells_.begin()); // Eliminar la primera fila (arriba)
-  cells_.pop_back(); // Eliminar la última fila (abajo)
-  rows -= 2; // Se eliminan dos filas
+  if (edited_)
+  {
+    engine_->reset();
+    edited_ = false;
+  }
+  engine_->step(board_, next_, stats_);
+  if (stats_ != nullptr)
+  {
+    stats_->endGeneration();
+  }
 
-  // Restaurar las posiciones de las células existentes
-  this->updatePositions();
-}
+  // la muestra de la política compara las dos generaciones antes de intercambiarlas
+  const bool sample = policy_ && (generation_ + 1) % sampleInterval_ == 0;
+  const double changedTiles = sample ? changedTileFraction(board_, next_) : 0;
 
+  this->updateStates();
+  ++generation_;
 
-// Calculo de la siguiente generación
-void Lattice::nextGeneration() {
-  if (this->getFrontera() == "abiertaFria")
+  if (frontera_ == Frontera::noBorder)
   {
+    this->growBorders();
+  }
 
-    this->openFrontier(false); // expande el lattice con celulas tipo false
-    for (int i = 1; i < this->getRows() - 1; i++)
-    {
-      for (int j = 1; j < this->getCols() - 1; j++)
-      {
-        std::vector<Cell> neighbors = this->cells_[i][j]->getNeighbors(*this); // vecinos de cada celula
-        State nextState = this->cells_[i][j]->transitionFunction(neighbors); // estado siguiente segun funcion transic.
-        this->cells_[i][j]->setNextState(nextState);
-      }
-    }
-    this->updateStates();
-    this->removeBorders(); // volver al tamaño original
-    
-    
-  } else if (this->getFrontera() == "abiertaCaliente")
+  // Límite de generación: entran las ediciones pendientes
+  this->applyPendingEdits();
+
+  if (history_ != nullptr)
   {
-    this->openFrontier(true); // expande el lattice con celulas tipo true
-    for (int i = 1; i < this->getRows() - 1; i++)
-    {
-      for (int j = 1; j < this->getCols() - 1; j++)
-      {
-        std::vector<Cell> neighbors = this->cells_[i][j]->getNeighbors(*this); // vecinos de cada celula
-        State nextState = this->cells_[i][j]->transitionFunction(neighbors); // estado siguiente segun funcion transic.
-        this->cells_[i][j]->setNextState(nextState);
-      }
-    }
-    this->updateStates();
-    this->removeBorders(); // volver al tamaño original
-    
+    history_->append(generation_, board_);
+  }
+  if (frames_ != nullptr)
+  {
+    frames_->write(generation_, board_);
+  }
 
-  } else if (this->getFrontera() == "periodic")
+  if (sample)
   {
+    this->adaptEngine(changedTiles);
+  }
+}
 
-    this->periodicFrontier(); // expande el lattice con frontera periodica
-    for (int i = 1; i < this->getRows() - 1; i++)
-    {
-      for (int j = 1; j < this->getCols() - 1; j++)
-      {
-        std::vector<Cell> neighbors = this->cells_[i][j]->getNeighbors(*this); // vecinos de cada celula
-        State nextState = this->cells_[i][j]->transitionFunction(neighbors); // estado siguiente segun funcion transic.
-        this->cells_[i][j]->setNextState(nextState);
-      }
-    }
-    this->updateStates();
-    this->removeBorders(); // volver al tamaño original
-    
+void Lattice::adaptEngine(double changedTiles) {
+  EngineSample sample;
+  const double cells = static_cast<double>(rows) * cols;
+  sample.density = cells > 0 ? this->Population() / cells : 0;
+  sample.changedTiles = changedTiles;
+  int r0, c0, r1, c1;
+  sample.boundingBoxArea = board_.boundingBox(r0, c0, r1, c1) ? static_cast<double>(r1 - r0) * (c1 - c0) / cells : 0;
+  sample.boundingBoxGrowth = lastBoxArea_ > 0 ? sample.boundingBoxArea / lastBoxArea_ : 1;
+  lastBoxArea_ = sample.boundingBoxArea;
+
+  const EngineKind current = engine_->kind();
+  const EngineKind chosen = policy_->decide(current, sample);
+  if (chosen != current)
+  {
+    std::cerr << "Generación " << generation_ << ": densidad " << sample.density
+              << ", baldosas cambiadas " << sample.changedTiles
+              << ", caja " << sample.boundingBoxArea << " (x" << sample.boundingBoxGrowth << ")"
+              << ": núcleo " << engineToString(current) << " -> " << engineToString(chosen) << std::endl;
+    engine_ = makeEngine(chosen, rule_);
+  }
+}
 
-  } else if (this->getFrontera() == "noBorder") {
+void Lattice::nextGeneration() {
+  this->step();
 
-    for (int i = 0; i < this->getRows(); i++)
-    {
-      for (int j = 0; j < this->getCols(); j++)
-      {
-        std::vector<Cell> neighbors = this->cells_[i][j]->getNeighbors(*this); // vecinos de cada celula
-        State nextState = this->cells_[i][j]->transitionFunction(neighbors); // estado siguiente segun funcion transic.
-        this->cells_[i][j]->setNextState(nextState);
-      }
-    }
-    this->updateStates();
-    for (int i = 0; i < this->getRows(); i++)
-    {
-      for (int j = 0; j < this->getCols(); j++)
-      {
-        if (this->cells_[i][j]->getState())
-        {
-          this->noFrontier(i,j);
-        }
-      }
-    }
-    
-    
-  }
   if (this->getPopMode())
   {
     std::cout << "Número de células vivas: " << this->Population() << std::endl << std::endl;
@@ -488,18 +430,35 @@ void Lattice::nextGeneration() {
   {
     std::cout << *this << std::endl << std::endl; // sacar por pantalla
   }
-  
+
 }
 
+// Tableros mayores que esto se imprimen reducidos a una vista de kPrintRows x kPrintCols
+static const long long kMaxPrintedCells = 1 << 16;
+static const int kPrintRows = 40;
+static const int kPrintCols = 120;
+
 // sobrecarga operador<<
 std::ostream& operator<<(std::ostream& os, const Lattice& lattice) {
+  if (static_cast<long long>(lattice.getRows()) * lattice.getCols() > kMaxPrintedCells)
+  {
+    Viewport view;
+    view.zoom = fitZoom(lattice.getRows(), lattice.getCols(), kPrintRows, kPrintCols);
+    std::string text;
+    renderViewport(lattice.getBoard(), view, kPrintRows, kPrintCols, text);
+    return os << "Vista reducida 1:" << view.zoom << " de " << lattice.getRows() << "x" << lattice.getCols()
+              << std::endl << text;
+  }
+
+  // Se compone cada fila entera y se escribe de una vez
+  std::string row(lattice.getCols(), '-');
   for (int i = 0; i < lattice.getRows(); i++)
   {
     for (int j = 0; j < lattice.getCols(); j++)
     {
-      os << lattice[std::make_pair(i,j)];
+      row[j] = lattice.at_unchecked(i, j) ? 'X' : '-';
     }
-    os << std::endl;
+    os << row << std::endl;
   }
 
   return os;
@@ -516,12 +475,13 @@ void Lattice::saveToFile(const char* filename) const {
   // Escribir las dimensiones del tablero
   file << rows << " " << cols << std::endl;
 
-  // Escribir el estado de cada celda en el tablero
+  // Escribir el estado de cada celda en el tablero, una fila cada vez
+  std::string row(cols, ' ');
   for (int i = 0; i < rows; ++i) {
     for (int j = 0; j < cols; ++j) {
-      file << (cells_[i][j]->getState() ? 'X' : ' ');
+      row[j] = at_unchecked(i, j) ? 'X' : ' ';
     }
-    file << std::endl;
+    file << row << '\n';
   }
 
   // Cerrar el archivo
@@ -538,15 +498,22 @@ Lattice& Lattice::operator=(const Lattice& other) {
     cols = other.cols;
     popMode = other.popMode;
     frontera_ = other.frontera_;
-    std::vector<Cell*> cells;
-
-    // Copiar el estado de las células
-    for (int i = 0; i < rows; ++i) {
-        cells_.push_back(cells);
-        for (int j = 0; j < cols; ++j) {
-            cells_[i].push_back(new Cell(*other.cells_[i][j]));
-        }
-    }
+    generation_ = other.generation_;
+    pendingEdits_ = other.pendingEdits_;
+    history_ = other.history_;
+    frames_ = other.frames_;
+    stats_ = other.stats_;
+    rule_ = other.rule_;
+    engine_ = makeEngine(other.engine_->kind(), rule_);
+    policy_.reset(other.policy_ ? new EnginePolicy(*other.policy_) : nullptr);
+    sampleInterval_ = other.sampleInterval_;
+    lastBoxArea_ = other.lastBoxArea_;
+    edited_ = true;
+    loadError_ = other.loadError_;
+
+    // Copiar el estado de las células, halo incluido
+    board_ = other.board_;
+    next_ = Bitboard(rows, cols);
 
     return *this;
 }
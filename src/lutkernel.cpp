@@ -0,0 +1,96 @@
+#include "lutkernel.h"
+
+#include <algorithm>
+
+LutKernel::LutKernel(const Rule& rule) : rule_(rule), table_(1 << 16) {
+  for (int index = 0; index < (1 << 16); ++index) {
+    std::uint8_t result = 0;
+    // las cuatro células centrales: filas 1 y 2, columnas 1 y 2 del vecindario
+    for (int r = 1; r <= 2; ++r) {
+      for (int c = 1; c <= 2; ++c) {
+        int aliveCount = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+          for (int dc = -1; dc <= 1; ++dc) {
+            if (dr != 0 || dc != 0) {
+              aliveCount += (index >> (4 * (r + dr) + c + dc)) & 1;
+            }
+          }
+        }
+        const bool alive = (index >> (4 * r + c)) & 1;
+        result |= rule_.next(alive, aliveCount) << ((r - 1) * 2 + (c - 1));
+      }
+    }
+    table_[index] = result;
+  }
+}
+
+const Rule& LutKernel::getRule() const {
+  return rule_;
+}
+
+// Columnas k*64 - 1 .. k*64 + 64 de una fila en 66 bits: low tiene las 64 primeras
+// y high las dos últimas
+static inline void window(const std::uint64_t* row, int k, std::uint64_t& low, std::uint64_t& high) {
+  low = (row[k] << 1) | (row[k - 1] >> 63);
+  high = (row[k] >> 63) | ((row[k + 1] & 1) << 1);
+}
+
+// Las 4 columnas del vecindario del bloque b de la palabra
+static inline std::uint32_t nibble(std::uint64_t low, std::uint64_t high, int b) {
+  return b < 31 ? static_cast<std::uint32_t>(low >> (2 * b)) & 0xF
+                : static_cast<std::uint32_t>((low >> 62) | (high << 2));
+}
+
+void LutKernel::step(const Bitboard& board, Bitboard& next, CellStats* stats) const {
+  const int rows = board.getRows();
+  const int words = board.getWords();
+  const std::uint64_t mask = board.lastWordMask();
+  const std::uint8_t* table = table_.data();
+  // fila muerta para el vecindario de la última fila cuando rows es impar
+  const std::vector<std::uint64_t> empty(board.getStride(), 0);
+
+  for (int i = 0; i < rows; i += 2) {
+    const bool pair = i + 1 < rows;
+    const std::uint64_t* r0 = board.row(i - 1);
+    const std::uint64_t* r1 = board.row(i);
+    const std::uint64_t* r2 = board.row(i + 1);
+    const std::uint64_t* r3 = pair ? board.row(i + 2) : empty.data();
+    std::uint64_t* out0 = next.row(i);
+    std::uint64_t* out1 = pair ? next.row(i + 1) : nullptr;
+
+    for (int k = 1; k <= words; ++k) {
+      std::uint64_t low0, high0, low1, high1, low2, high2, low3, high3;
+      window(r0, k, low0, high0);
+      window(r1, k, low1, high1);
+      window(r2, k, low2, high2);
+      window(r3, k, low3, high3);
+
+      std::uint64_t top = 0;
+      std::uint64_t bottom = 0;
+      for (int b = 0; b < 32; ++b) {
+        const std::uint32_t index = nibble(low0, high0, b) | (nibble(low1, high1, b) << 4) |
+                                    (nibble(low2, high2, b) << 8) | (nibble(low3, high3, b) << 12);
+        const std::uint64_t result = table[index];
+        top |= (result & 3) << (2 * b);
+        bottom |= (result >> 2) << (2 * b);
+      }
+
+      // las columnas de relleno de la última palabra se quedan a cero
+      if (k == words) {
+        top &= mask;
+        bottom &= mask;
+      }
+      out0[k] = top;
+      if (pair) {
+        out1[k] = bottom;
+      }
+    }
+
+    if (stats != nullptr) {
+      stats->updateRow(i, r1, out0);
+      if (pair) {
+        stats->updateRow(i + 1, r2, out1);
+      }
+    }
+  }
+}
@@ -0,0 +1,342 @@
+#include "outofcore.h"
+#include "textboard.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Cabecera del fichero empaquetado; ocupa una página entera para que las filas
+// empiecen alineadas
+static const char kMagic[8] = {'L', 'G', 'P', 'A', 'C', 'K', '0', '1'};
+static const std::size_t kHeaderBytes = 4096;
+static const std::size_t kBandBytes = std::size_t(8) << 20;
+
+struct PackedHeader {
+  char magic[8];
+  std::uint32_t rows;
+  std::uint32_t cols;
+  std::uint64_t generation;
+};
+
+static std::size_t packedBytes(int rows, int cols) {
+  return kHeaderBytes + static_cast<std::size_t>(rows) * ((cols + 63) / 64) * sizeof(std::uint64_t);
+}
+
+// madvise y msync necesitan direcciones alineadas a página: se amplía el rango
+static void alignRange(std::size_t& begin, std::size_t& end) {
+  static const std::size_t page = sysconf(_SC_PAGESIZE);
+  begin = begin / page * page;
+  end = (end + page - 1) / page * page;
+}
+
+static void adviseRange(char* base, std::size_t begin, std::size_t end, int advice) {
+  alignRange(begin, end);
+  if (end > begin) {
+    madvise(base + begin, end - begin, advice);
+  }
+}
+
+// empezar a escribir en disco sin esperar
+static void flushRange(char* base, std::size_t begin, std::size_t end) {
+  alignRange(begin, end);
+  if (end > begin) {
+    msync(base + begin, end - begin, MS_ASYNC);
+  }
+}
+
+// Dejar en disco la entrada de directorio de un fichero recién renombrado
+static void syncDirectory(const std::string& filename) {
+  const std::size_t slash = filename.rfind('/');
+  const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash);
+  int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+}
+
+// Crear un fichero empaquetado vacío del tamaño justo y proyectarlo
+static char* createPacked(const char* filename, int rows, int cols, std::size_t generation, int& fd) {
+  const std::size_t bytes = packedBytes(rows, cols);
+  fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || ftruncate(fd, bytes) < 0) {
+    std::cerr << "Error: No se pudo crear el archivo " << filename << ": " << std::strerror(errno) << std::endl;
+    return nullptr;
+  }
+  void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (region == MAP_FAILED) {
+    std::cerr << "Error: No se pudo proyectar " << filename << std::endl;
+    return nullptr;
+  }
+  PackedHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.rows = rows;
+  header.cols = cols;
+  header.generation = generation;
+  std::memcpy(region, &header, sizeof(header));
+  return static_cast<char*>(region);
+}
+
+bool OutOfCoreLattice::convertText(const char* textFile, const char* packedFile) {
+  TextBoard text(textFile);
+  if (!text.isOpen()) {
+    return false;
+  }
+  const int rows = text.getRows();
+  const int cols = text.getCols();
+  if (rows <= 0 || cols <= 0) {
+    std::cerr << "Error: Dimensiones no válidas en " << textFile << std::endl;
+    return false;
+  }
+
+  int fd;
+  char* region = createPacked(packedFile, rows, cols, 0, fd);
+  if (region == nullptr) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  // las filas del fichero empaquetado son las palabras interiores, seguidas
+  const bool ok = text.pack(reinterpret_cast<std::uint64_t*>(region + kHeaderBytes), (cols + 63) / 64);
+  munmap(region, packedBytes(rows, cols));
+  close(fd);
+  return ok;
+}
+
+OutOfCoreLattice::OutOfCoreLattice(const char* packedFile, Frontera frontera, int bandRows)
+    : filename_(packedFile), frontera_(frontera) {
+  rows = 0;
+  cols = 0;
+  words_ = 0;
+  bandRows_ = bandRows;
+  generation_ = 0;
+  fd_ = -1;
+  map_ = nullptr;
+  mapBytes_ = 0;
+  if (frontera == Frontera::noBorder) {
+    std::cerr << "Error: El modo fuera de memoria requiere una frontera de tamaño fijo." << std::endl;
+    return;
+  }
+  if (!map(packedFile)) {
+    unmap();
+    return;
+  }
+  if (bandRows_ <= 0) {
+    bandRows_ = static_cast<int>(std::max<std::size_t>(1, kBandBytes / (words_ * sizeof(std::uint64_t))));
+  }
+}
+
+OutOfCoreLattice::~OutOfCoreLattice() {
+  unmap();
+}
+
+bool OutOfCoreLattice::map(const char* filename) {
+  fd_ = open(filename, O_RDWR);
+  struct stat info;
+  if (fd_ < 0 || fstat(fd_, &info) < 0 || static_cast<std::size_t>(info.st_size) < kHeaderBytes) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return false;
+  }
+  PackedHeader header;
+  if (pread(fd_, &header, sizeof(header), 0) != sizeof(header) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      packedBytes(header.rows, header.cols) != static_cast<std::size_t>(info.st_size)) {
+    std::cerr << "Error: " << filename << " no es un tablero empaquetado válido." << std::endl;
+    return false;
+  }
+  rows = header.rows;
+  cols = header.cols;
+  words_ = (cols + 63) / 64;
+  generation_ = header.generation;
+  mapBytes_ = info.st_size;
+  // lectura anticipada agresiva: el fichero se recorre siempre de principio a fin
+  posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  void* region = mmap(nullptr, mapBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (region == MAP_FAILED) {
+    std::cerr << "Error: No se pudo proyectar " << filename << std::endl;
+    return false;
+  }
+  map_ = static_cast<char*>(region);
+  return true;
+}
+
+void OutOfCoreLattice::unmap() {
+  if (map_ != nullptr) {
+    munmap(map_, mapBytes_);
+    map_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool OutOfCoreLattice::isReady() const {
+  return map_ != nullptr;
+}
+
+int OutOfCoreLattice::getRows() const {
+  return rows;
+}
+
+int OutOfCoreLattice::getCols() const {
+  return cols;
+}
+
+std::size_t OutOfCoreLattice::getGeneration() const {
+  return generation_;
+}
+
+const std::uint64_t* OutOfCoreLattice::packedRow(int row) const {
+  return reinterpret_cast<const std::uint64_t*>(map_ + kHeaderBytes) + static_cast<std::size_t>(row) * words_;
+}
+
+void OutOfCoreLattice::loadRow(Bitboard& band, int bandRow, int row) const {
+  std::uint64_t* out = band.row(bandRow);
+  if (row < 0 || row >= rows) {
+    if (frontera_ == Frontera::periodic) {
+      row = (row + rows) % rows;
+    } else {
+      // fila del halo: toda muerta o toda viva, esquinas incluidas
+      std::fill(out, out + band.getStride(), frontera_ == Frontera::abiertaCaliente ? ~std::uint64_t(0) : 0);
+      return;
+    }
+  }
+  out[0] = 0;
+  std::memcpy(out + 1, packedRow(row), words_ * sizeof(std::uint64_t));
+  out[words_ + 1] = 0;
+  out[words_] &= band.lastWordMask();
+  // columnas -1 y cols según la frontera
+  bool left = frontera_ == Frontera::abiertaCaliente;
+  bool right = left;
+  if (frontera_ == Frontera::periodic) {
+    left = band.get(bandRow, cols - 1);
+    right = band.get(bandRow, 0);
+  }
+  band.set(bandRow, -1, left);
+  band.set(bandRow, cols, right);
+}
+
+void OutOfCoreLattice::step() {
+  const std::string nextName = filename_ + ".next";
+  int nextFd;
+  char* next = createPacked(nextName.c_str(), rows, cols, generation_ + 1, nextFd);
+  if (next == nullptr) {
+    if (nextFd >= 0) {
+      close(nextFd);
+    }
+    return;
+  }
+
+  const std::size_t rowBytes = words_ * sizeof(std::uint64_t);
+  adviseRange(map_, kHeaderBytes, mapBytes_, MADV_SEQUENTIAL);
+  adviseRange(next, kHeaderBytes, mapBytes_, MADV_SEQUENTIAL);
+
+  Bitboard band(std::min(bandRows_, rows), cols);
+  Bitboard result(std::min(bandRows_, rows), cols);
+  for (int begin = 0; begin < rows; begin += bandRows_) {
+    const int end = std::min(begin + bandRows_, rows);
+    const int count = end - begin;
+    if (count != band.getRows()) {
+      band = Bitboard(count, cols);
+      result = Bitboard(count, cols);
+    }
+
+    // pedir ya la franja siguiente mientras se calcula esta
+    if (end < rows) {
+      const int aheadEnd = std::min(end + bandRows_, rows);
+      adviseRange(map_, kHeaderBytes + end * rowBytes, kHeaderBytes + aheadEnd * rowBytes, MADV_WILLNEED);
+    }
+
+    // la franja con su halo: una fila de cada vecina
+    for (int i = -1; i <= count; ++i) {
+      loadRow(band, i, begin + i);
+    }
+    band.step(result);
+
+    std::uint64_t* out = reinterpret_cast<std::uint64_t*>(next + kHeaderBytes) + static_cast<std::size_t>(begin) * words_;
+    for (int i = 0; i < count; ++i) {
+      std::memcpy(out + static_cast<std::size_t>(i) * words_, result.row(i) + 1, rowBytes);
+    }
+
+    // Soltar lo que ya no hace falta: la franja anterior de la entrada (salvo su
+    // última fila, halo de esta); la salida recién escrita se manda ya a disco
+    if (begin > 0) {
+      adviseRange(map_, kHeaderBytes + std::max(begin - bandRows_, 0) * rowBytes,
+                  kHeaderBytes + (begin - 1) * rowBytes, MADV_DONTNEED);
+    }
+    flushRange(next, kHeaderBytes + begin * rowBytes, kHeaderBytes + end * rowBytes);
+  }
+
+  // El fichero nuevo sustituye a la única copia del tablero: tiene que estar
+  // entero en disco antes del rename
+  bool synced = msync(next, mapBytes_, MS_SYNC) == 0 && fsync(nextFd) == 0;
+  const int syncError = errno;
+  munmap(next, mapBytes_);
+  close(nextFd);
+  if (!synced) {
+    std::cerr << "Error: No se pudo escribir " << nextName << ": " << std::strerror(syncError) << std::endl;
+    unlink(nextName.c_str());
+    return;
+  }
+  unmap();
+  if (std::rename(nextName.c_str(), filename_.c_str()) != 0) {
+    std::cerr << "Error: No se pudo sustituir " << filename_ << std::endl;
+  } else {
+    syncDirectory(filename_);
+  }
+  if (!map(filename_.c_str())) {
+    unmap();
+  }
+}
+
+void OutOfCoreLattice::nextGeneration(int generations) {
+  for (int g = 0; g < generations && isReady(); ++g) {
+    step();
+  }
+}
+
+std::size_t OutOfCoreLattice::Population() const {
+  if (!isReady()) {
+    return 0;
+  }
+  adviseRange(map_, kHeaderBytes, mapBytes_, MADV_SEQUENTIAL);
+  // columnas válidas de la última palabra
+  const std::uint64_t mask = cols % 64 ? (std::uint64_t(1) << (cols % 64)) - 1 : ~std::uint64_t(0);
+  std::size_t aliveCount = 0;
+  for (int i = 0; i < rows; ++i) {
+    const std::uint64_t* r = packedRow(i);
+    for (int k = 0; k + 1 < words_; ++k) {
+      aliveCount += __builtin_popcountll(r[k]);
+    }
+    aliveCount += __builtin_popcountll(r[words_ - 1] & mask);
+  }
+  return aliveCount;
+}
+
+void OutOfCoreLattice::saveToFile(const char* filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return;
+  }
+  adviseRange(map_, kHeaderBytes, mapBytes_, MADV_SEQUENTIAL);
+  file << rows << " " << cols << std::endl;
+  std::string row(cols, ' ');
+  for (int i = 0; i < rows; ++i) {
+    const std::uint64_t* r = packedRow(i);
+    for (int j = 0; j < cols; ++j) {
+      row[j] = ((r[j >> 6] >> (j & 63)) & 1) ? 'X' : ' ';
+    }
+    file << row << '\n';
+  }
+}
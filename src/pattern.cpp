@@ -0,0 +1,97 @@
+#include "pattern.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+Bitboard makePattern(const std::vector<std::string>& rows) {
+  std::size_t width = 0;
+  for (const auto& row : rows) {
+    width = std::max(width, row.length());
+  }
+  Bitboard pattern(static_cast<int>(rows.size()), static_cast<int>(width));
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    for (std::size_t j = 0; j < rows[i].length(); ++j) {
+      pattern.set(static_cast<int>(i), static_cast<int>(j), rows[i][j] == 'X');
+    }
+  }
+  return pattern;
+}
+
+bool namedPattern(const std::string& nombre, Bitboard& pattern) {
+  if (nombre == "glider") {
+    pattern = makePattern({" X ",
+                           "  X",
+                           "XXX"});
+  } else if (nombre == "lwss") {
+    pattern = makePattern({" X  X",
+                           "X    ",
+                           "X   X",
+                           "XXXX "});
+  } else if (nombre == "blinker") {
+    pattern = makePattern({"XXX"});
+  } else if (nombre == "block") {
+    pattern = makePattern({"XX",
+                           "XX"});
+  } else if (nombre == "rpentomino") {
+    pattern = makePattern({" XX",
+                           "XX ",
+                           " X "});
+  } else if (nombre == "gosperGun") {
+    pattern = makePattern({"                        X           ",
+                           "                      X X           ",
+                           "            XX      XX            XX",
+                           "           X   X    XX            XX",
+                           "XX        X     X   XX              ",
+                           "XX        X   X XX    X X           ",
+                           "          X     X       X           ",
+                           "           X   X                    ",
+                           "            XX                      "});
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool loadPattern(const char* filename, Bitboard& pattern) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+    return false;
+  }
+  int rows, cols;
+  if (!(file >> rows >> cols) || rows <= 0 || cols <= 0) {
+    std::cerr << "Error: Cabecera no válida en el archivo " << filename << std::endl;
+    return false;
+  }
+  file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+  std::vector<std::string> lines(rows);
+  for (int i = 0; i < rows; ++i) {
+    std::getline(file, lines[i]);
+    if (static_cast<int>(lines[i].length()) != cols) {
+      std::cerr << "Error: La longitud de la fila no coincide con el número de columnas especificado." << std::endl;
+      return false;
+    }
+  }
+  pattern = makePattern(lines);
+  return true;
+}
+
+bool findPattern(const std::string& nombre, Bitboard& pattern) {
+  return namedPattern(nombre, pattern) || loadPattern(nombre.c_str(), pattern);
+}
+
+bool parseStampMode(const std::string& nombre, StampMode& mode) {
+  if (nombre == "or") {
+    mode = StampMode::bitOr;
+  } else if (nombre == "xor") {
+    mode = StampMode::bitXor;
+  } else if (nombre == "set") {
+    mode = StampMode::overwrite;
+  } else {
+    return false;
+  }
+  return true;
+}
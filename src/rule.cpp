@@ -0,0 +1,49 @@
+#include "rule.h"
+
+#include <cctype>
+
+bool parseRule(const std::string& nombre, Rule& rule) {
+  Rule parsed;
+  parsed.birth = 0;
+  parsed.survive = 0;
+  std::uint16_t* target = nullptr;
+  bool seenBirth = false;
+  bool seenSurvive = false;
+  for (char c : nombre) {
+    const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    if (upper == 'B' && !seenBirth && !seenSurvive) {
+      target = &parsed.birth;
+      seenBirth = true;
+    } else if (upper == 'S' && seenBirth && !seenSurvive) {
+      target = &parsed.survive;
+      seenSurvive = true;
+    } else if (c == '/' && target == &parsed.birth) {
+      continue;
+    } else if (c >= '0' && c <= '8' && target != nullptr) {
+      *target |= 1 << (c - '0');
+    } else {
+      return false;
+    }
+  }
+  if (!seenBirth || !seenSurvive) {
+    return false;
+  }
+  rule = parsed;
+  return true;
+}
+
+std::string ruleToString(const Rule& rule) {
+  std::string nombre = "B";
+  for (int n = 0; n <= 8; ++n) {
+    if ((rule.birth >> n) & 1) {
+      nombre += static_cast<char>('0' + n);
+    }
+  }
+  nombre += "/S";
+  for (int n = 0; n <= 8; ++n) {
+    if ((rule.survive >> n) & 1) {
+      nombre += static_cast<char>('0' + n);
+    }
+  }
+  return nombre;
+}
@@ -0,0 +1,475 @@
+#include "server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "pattern.h"
+
+static void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+SimulationServer::SimulationServer(const char* socketPath, int threads) : socketPath_(socketPath) {
+  listenFd_ = -1;
+  wakePipe_[0] = wakePipe_[1] = -1;
+  stop_ = false;
+  nextClient_ = 0;
+  poolStop_ = false;
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath_.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Error: La ruta del socket es demasiado larga." << std::endl;
+    return;
+  }
+  std::strcpy(address.sun_path, socketPath_.c_str());
+
+  listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(socketPath_.c_str()); // un socket de una ejecución anterior
+  if (listenFd_ < 0 || bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+      listen(listenFd_, 64) < 0 || pipe(wakePipe_) < 0) {
+    std::cerr << "Error: No se pudo escuchar en " << socketPath_ << ": " << std::strerror(errno) << std::endl;
+    if (listenFd_ >= 0) {
+      close(listenFd_);
+      listenFd_ = -1;
+    }
+    return;
+  }
+
+  // el aviso es solo un byte: si la tubería está llena ya hay uno pendiente
+  setNonBlocking(wakePipe_[0]);
+  setNonBlocking(wakePipe_[1]);
+
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int t = 0; t < threads; ++t) {
+    workers_.emplace_back(&SimulationServer::workerLoop, this);
+  }
+}
+
+SimulationServer::~SimulationServer() {
+  {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    poolStop_ = true;
+  }
+  poolWake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  for (auto& entry : clients_) {
+    close(entry.second.fd);
+  }
+  if (listenFd_ >= 0) {
+    close(listenFd_);
+    unlink(socketPath_.c_str());
+  }
+  for (int fd : wakePipe_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool SimulationServer::isReady() const {
+  return listenFd_ >= 0;
+}
+
+// ---------------------------------------------------------------------------
+// Grupo de hilos y colas por tablero
+
+void SimulationServer::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(poolMutex_);
+      poolWake_.wait(lock, [this]() { return poolStop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return; // parada con la cola vacía
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void SimulationServer::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    tasks_.push_back(std::move(task));
+  }
+  poolWake_.notify_one();
+}
+
+// La orden entra en la cola del tablero; si nadie la está vaciando, se encarga
+// un hilo del grupo
+void SimulationServer::submitToBoard(const std::shared_ptr<Board>& board, std::function<void()> task) {
+  std::lock_guard<std::mutex> lock(board->mutex);
+  board->queue.push_back(std::move(task));
+  if (!board->running) {
+    board->running = true;
+    submit([this, board]() { drainBoard(board); });
+  }
+}
+
+void SimulationServer::drainBoard(std::shared_ptr<Board> board) {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::lock_guard<std::mutex> lock(board->mutex);
+      if (board->queue.empty()) {
+        board->running = false;
+        return;
+      }
+      task = std::move(board->queue.front());
+      board->queue.pop_front();
+    }
+    task();
+  }
+}
+
+std::shared_ptr<SimulationServer::Board> SimulationServer::findBoard(const std::string& name) {
+  std::lock_guard<std::mutex> lock(boardsMutex_);
+  auto found = boards_.find(name);
+  return found == boards_.end() ? nullptr : found->second;
+}
+
+// ---------------------------------------------------------------------------
+// Clientes
+
+// Respuesta desde el bucle principal: se añade al búfer de salida del cliente
+// y se envía lo que admita el socket sin bloquear
+void SimulationServer::reply(int clientId, const std::string& text) {
+  clients_[clientId].output += text + "\n";
+  flushClient(clientId);
+}
+
+// Respuesta desde un hilo del grupo: queda para el bucle principal, que es el
+// único que toca los clientes, y se le despierta
+void SimulationServer::finish(int clientId, const std::string& text) {
+  {
+    std::lock_guard<std::mutex> lock(finishedMutex_);
+    finished_.emplace_back(clientId, text);
+  }
+  const char wake = 0;
+  ssize_t ignored = write(wakePipe_[1], &wake, 1);
+  (void)ignored;
+}
+
+// Recoger las respuestas de los hilos: el cliente queda libre para su siguiente orden
+void SimulationServer::collectFinished() {
+  char drain[256];
+  while (read(wakePipe_[0], drain, sizeof(drain)) > 0) {
+  }
+  std::vector<std::pair<int, std::string>> finished;
+  {
+    std::lock_guard<std::mutex> lock(finishedMutex_);
+    finished.swap(finished_);
+  }
+  for (const auto& entry : finished) {
+    clients_[entry.first].busy = false;
+    reply(entry.first, entry.second);
+  }
+}
+
+// Enviar lo que se pueda del búfer de salida. Si el cliente ya no está, se descarta
+void SimulationServer::flushClient(int clientId) {
+  Client& client = clients_[clientId];
+  while (!client.output.empty()) {
+    ssize_t n = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+    if (n > 0) {
+      client.output.erase(0, n);
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return; // el resto sale cuando poll() avise de POLLOUT
+    } else {
+      client.output.clear();
+      client.closing = true;
+      return;
+    }
+  }
+}
+
+void SimulationServer::dispatch(int clientId, const std::string& line) {
+  std::istringstream input(line);
+  std::string command, name;
+  input >> command >> name;
+  if (command.empty()) {
+    reply(clientId, "ERROR orden vacía");
+    return;
+  }
+
+  if (command == "quit") {
+    reply(clientId, "OK");
+    clients_[clientId].closing = true;
+    return;
+  }
+  if (command == "shutdown") {
+    reply(clientId, "OK");
+    stop_ = true;
+    return;
+  }
+  if (command == "list") {
+    std::string names = "OK";
+    {
+      std::lock_guard<std::mutex> lock(boardsMutex_);
+      for (const auto& entry : boards_) {
+        names += " " + entry.first;
+      }
+    }
+    reply(clientId, names);
+    return;
+  }
+  if (name.empty()) {
+    reply(clientId, "ERROR falta el nombre del tablero");
+    return;
+  }
+  if (command == "drop") {
+    bool dropped;
+    {
+      std::lock_guard<std::mutex> lock(boardsMutex_);
+      dropped = boards_.erase(name) > 0;
+    }
+    reply(clientId, dropped ? "OK" : "ERROR no existe el tablero " + name);
+    return;
+  }
+
+  clients_[clientId].busy = true;
+
+  if (command == "load" || command == "random") {
+    // El tablero se construye en un hilo del grupo y sustituye al del mismo nombre
+    std::vector<std::string> args;
+    std::string arg;
+    while (input >> arg) {
+      args.push_back(arg);
+    }
+    submit([this, clientId, command, name, args]() {
+      const std::size_t fixed = command == "load" ? 1 : 4;
+      Frontera frontera = Frontera::abiertaFria;
+      if (args.size() < fixed || args.size() > fixed + 1 ||
+          (args.size() == fixed + 1 && !parseFrontera(args[fixed], frontera))) {
+        finish(clientId, command == "load" ? "ERROR uso: load <nombre> <fichero> [frontera]"
+                                               : "ERROR uso: random <nombre> <filas> <columnas> <semilla> <densidad> [frontera]");
+        return;
+      }
+      std::unique_ptr<Lattice> lattice;
+      try {
+        if (command == "load") {
+          lattice.reset(new Lattice(args[0].c_str()));
+        } else {
+          lattice.reset(new Lattice(std::stoi(args[0]), std::stoi(args[1]), std::stoull(args[2]), std::stod(args[3])));
+        }
+      } catch (const std::exception&) {
+        finish(clientId, "ERROR argumentos no válidos");
+        return;
+      }
+      // un fichero con filas incorrectas no se acepta a medias
+      if (!lattice->getLoadError().empty()) {
+        finish(clientId, "ERROR " + lattice->getLoadError());
+        return;
+      }
+      if (lattice->getRows() == 0 || lattice->getCols() == 0) {
+        finish(clientId, "ERROR no se pudo leer " + args[0]);
+        return;
+      }
+      lattice->setFrontera(frontera);
+      const std::string answer = "OK " + std::to_string(lattice->getRows()) + " " + std::to_string(lattice->getCols());
+
+      std::shared_ptr<Board> board = std::make_shared<Board>();
+      board->lattice = std::move(lattice);
+      {
+        std::lock_guard<std::mutex> lock(boardsMutex_);
+        boards_[name] = board;
+      }
+      finish(clientId, answer);
+    });
+    return;
+  }
+
+  std::shared_ptr<Board> board = findBoard(name);
+  if (!board) {
+    clients_[clientId].busy = false;
+    reply(clientId, "ERROR no existe el tablero " + name);
+    return;
+  }
+
+  // El resto de órdenes trabajan sobre el tablero, en su cola
+  std::vector<std::string> args;
+  std::string arg;
+  while (input >> arg) {
+    args.push_back(arg);
+  }
+  submitToBoard(board, [this, clientId, command, board, args]() {
+    Lattice& lattice = *board->lattice;
+    std::string answer;
+    try {
+      if (command == "step" && args.size() <= 1) {
+        const long long generations = args.empty() ? 1 : std::stoll(args[0]);
+        for (long long g = 0; g < generations; ++g) {
+          lattice.step();
+        }
+        answer = "OK " + std::to_string(lattice.getGeneration());
+      } else if (command == "population" && args.empty()) {
+        answer = "OK " + std::to_string(lattice.Population());
+      } else if (command == "bbox" && args.empty()) {
+        int r0, c0, r1, c1;
+        answer = lattice.getBoard().boundingBox(r0, c0, r1, c1)
+                     ? "OK " + std::to_string(r0) + " " + std::to_string(c0) + " " + std::to_string(r1) + " " +
+                           std::to_string(c1)
+                     : "OK vacio";
+      } else if (command == "snapshot" && args.size() == 1) {
+        lattice.saveToFile(args[0].c_str());
+        answer = "OK " + std::to_string(lattice.getGeneration());
+      } else if (command == "stamp" && args.size() == 4) {
+        Bitboard pattern;
+        StampMode mode;
+        if (!findPattern(args[0], pattern)) {
+          answer = "ERROR patrón desconocido " + args[0];
+        } else if (!parseStampMode(args[3], mode)) {
+          answer = "ERROR modo no válido " + args[3];
+        } else {
+          lattice.stamp(pattern, std::stoi(args[1]), std::stoi(args[2]), mode);
+          answer = "OK";
+        }
+      } else {
+        answer = "ERROR orden no válida: " + command;
+      }
+    } catch (const std::exception&) {
+      answer = "ERROR argumentos no válidos";
+    }
+    finish(clientId, answer);
+  });
+}
+
+void SimulationServer::acceptClient() {
+  int fd = accept(listenFd_, nullptr, nullptr);
+  if (fd < 0) {
+    return;
+  }
+  setNonBlocking(fd);
+  Client client;
+  client.fd = fd;
+  clients_[nextClient_++] = client;
+}
+
+void SimulationServer::readClient(int clientId) {
+  Client& client = clients_[clientId];
+  char data[4096];
+  ssize_t n = recv(client.fd, data, sizeof(data), 0);
+  if (n <= 0) {
+    if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    client.closing = true; // se cierra cuando no quede ninguna respuesta pendiente
+    return;
+  }
+  client.buffer.append(data, n);
+}
+
+// Despachar la siguiente línea completa si el cliente no espera ninguna respuesta
+// ni tiene respuestas sin enviar
+void SimulationServer::processBuffered(int clientId) {
+  Client& client = clients_[clientId];
+  while (!client.busy && !client.closing && client.output.empty() && !stop_) {
+    const std::size_t end = client.buffer.find('\n');
+    if (end == std::string::npos) {
+      return;
+    }
+    std::string line = client.buffer.substr(0, end);
+    client.buffer.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    dispatch(clientId, line);
+  }
+}
+
+int SimulationServer::run() {
+  if (!isReady()) {
+    return 1;
+  }
+  std::cout << "Servidor escuchando en " << socketPath_ << " con " << workers_.size() << " hilos" << std::endl;
+
+  while (!stop_) {
+    std::vector<pollfd> fds;
+    std::vector<int> ids;
+    fds.push_back({listenFd_, POLLIN, 0});
+    fds.push_back({wakePipe_[0], POLLIN, 0});
+    for (const auto& entry : clients_) {
+      // un cliente ocupado o con respuestas pendientes no se lee: sus órdenes
+      // esperan en el socket
+      short events = 0;
+      if (!entry.second.output.empty()) {
+        events = POLLOUT;
+      } else if (!entry.second.busy && !entry.second.closing) {
+        events = POLLIN;
+      }
+      if (events != 0) {
+        fds.push_back({entry.second.fd, events, 0});
+        ids.push_back(entry.first);
+      }
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "Error en poll(): " << std::strerror(errno) << std::endl;
+      return 1;
+    }
+
+    for (std::size_t k = 0; k < ids.size(); ++k) {
+      const short revents = fds[k + 2].revents;
+      if (fds[k + 2].events == POLLOUT) {
+        if (revents & (POLLOUT | POLLHUP | POLLERR)) {
+          flushClient(ids[k]);
+        }
+      } else if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        readClient(ids[k]);
+      }
+    }
+    if (fds[1].revents & POLLIN) {
+      collectFinished();
+    }
+    for (auto& entry : clients_) {
+      processBuffered(entry.first);
+    }
+    if (fds[0].revents & POLLIN) {
+      acceptClient();
+    }
+
+    // cerrar los clientes que se han ido y ya no esperan respuesta
+    for (auto it = clients_.begin(); it != clients_.end();) {
+      if (it->second.closing && !it->second.busy && it->second.output.empty()) {
+        close(it->second.fd);
+        it = clients_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // esperar a que terminen las órdenes en curso antes de salir
+  while (true) {
+    collectFinished();
+    bool busy = false;
+    for (const auto& entry : clients_) {
+      busy = busy || entry.second.busy;
+    }
+    if (!busy) {
+      break;
+    }
+    pollfd wake = {wakePipe_[0], POLLIN, 0};
+    poll(&wake, 1, -1);
+  }
+  return 0;
+}
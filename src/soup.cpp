@@ -0,0 +1,90 @@
+#include "soup.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Bits de probabilidad que se combinan por palabra
+static const int kDensityBits = 16;
+
+std::uint64_t splitmix64(std::uint64_t seed, std::uint64_t counter) {
+  std::uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Rellena las filas [rowBegin, rowEnd). Cada palabra se construye a partir de la
+// expansión binaria de la densidad: empezando por el bit menos significativo, un
+// 1 hace OR con una palabra aleatoria y un 0 hace AND, con lo que cada bit queda a
+// 1 con probabilidad threshold / 2^16 usando como mucho 16 números por 64 células
+static void fillRows(Bitboard& board, std::uint64_t seed, std::uint32_t threshold,
+                     int rowBegin, int rowEnd, int colBegin, int colEnd) {
+  const int words = board.getWords();
+  const int firstWord = colBegin / 64;
+  const int lastWord = (colEnd - 1) / 64;
+  int lowestBit = 0;
+  while (lowestBit < kDensityBits && ((threshold >> lowestBit) & 1) == 0) {
+    ++lowestBit;
+  }
+
+  for (int i = rowBegin; i < rowEnd; ++i) {
+    std::uint64_t* row = board.row(i);
+    for (int w = firstWord; w <= lastWord; ++w) {
+      // el contador depende solo de la posición de la palabra en el tablero
+      const std::uint64_t counter = (static_cast<std::uint64_t>(i) * words + w) * kDensityBits;
+      std::uint64_t bits = 0;
+      if (threshold >= (1u << kDensityBits)) {
+        bits = ~std::uint64_t(0);
+      } else {
+        for (int l = lowestBit; l < kDensityBits; ++l) {
+          const std::uint64_t random = splitmix64(seed, counter + l);
+          bits = ((threshold >> l) & 1) ? (bits | random) : (bits & random);
+        }
+      }
+
+      // columnas de la palabra que caen dentro del rectángulo
+      const int first = std::max(colBegin - w * 64, 0);
+      const int last = std::min(colEnd - w * 64, 64);
+      const std::uint64_t mask = (last == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << last) - 1) &
+                                 ~((std::uint64_t(1) << first) - 1);
+      row[w + 1] = (row[w + 1] & ~mask) | (bits & mask);
+    }
+  }
+}
+
+void randomSoup(Bitboard& board, std::uint64_t seed, double density,
+                int rowBegin, int colBegin, int rowEnd, int colEnd, int threads) {
+  rowBegin = std::max(rowBegin, 0);
+  colBegin = std::max(colBegin, 0);
+  rowEnd = std::min(rowEnd, board.getRows());
+  colEnd = std::min(colEnd, board.getCols());
+  if (rowBegin >= rowEnd || colBegin >= colEnd) {
+    return;
+  }
+
+  density = std::min(std::max(density, 0.0), 1.0);
+  const std::uint32_t threshold = static_cast<std::uint32_t>(density * (1u << kDensityBits) + 0.5);
+
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, rowEnd - rowBegin);
+
+  if (threads == 1) {
+    fillRows(board, seed, threshold, rowBegin, rowEnd, colBegin, colEnd);
+    return;
+  }
+
+  // cada hilo escribe un bloque de filas distinto, así que no comparten palabras
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; ++t) {
+    const int begin = rowBegin + static_cast<int>(static_cast<std::int64_t>(rowEnd - rowBegin) * t / threads);
+    const int end = rowBegin + static_cast<int>(static_cast<std::int64_t>(rowEnd - rowBegin) * (t + 1) / threads);
+    pool.emplace_back(fillRows, std::ref(board), seed, threshold, begin, end, colBegin, colEnd);
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+}
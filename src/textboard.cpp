@@ -0,0 +1,251 @@
+#include "textboard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Texto mínimo por hilo: con menos, arrancar el hilo cuesta más que leerlo
+static const std::size_t kBytesPerThread = std::size_t(1) << 20;
+
+// Bits de 64 caracteres seguidos: el bit k indica si text[k] es 'X'
+static inline std::uint64_t packWord(const char* text) {
+#if defined(__AVX2__)
+  const __m256i x = _mm256_set1_epi8('X');
+  const std::uint32_t low = _mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text)), x));
+  const std::uint32_t high = _mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + 32)), x));
+  return static_cast<std::uint64_t>(high) << 32 | low;
+#elif defined(__SSE2__)
+  const __m128i x = _mm_set1_epi8('X');
+  std::uint64_t word = 0;
+  for (int k = 0; k < 4; ++k) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16 * k));
+    word |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, x))))
+            << (16 * k);
+  }
+  return word;
+#else
+  std::uint64_t word = 0;
+  for (int k = 0; k < 64; ++k) {
+    word |= static_cast<std::uint64_t>(text[k] == 'X') << k;
+  }
+  return word;
+#endif
+}
+
+void packTextRow(const char* text, int cols, std::uint64_t* out) {
+  const int full = cols / 64;
+  for (int k = 0; k < full; ++k) {
+    out[k] = packWord(text + 64 * k);
+  }
+  const int tail = cols - 64 * full;
+  if (tail > 0) {
+    // el final de la fila se copia a un bloque completo para no leer fuera del texto
+    char block[64] = {};
+    std::memcpy(block, text + 64 * full, tail);
+    out[full] = packWord(block);
+  }
+}
+
+// Saltos de línea en [text, text + bytes)
+static std::size_t countNewlines(const char* text, std::size_t bytes) {
+  std::size_t count = 0;
+  std::size_t k = 0;
+#if defined(__SSE2__)
+  const __m128i newline = _mm_set1_epi8('\n');
+  for (; k + 16 <= bytes; k += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + k));
+    count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, newline)));
+  }
+#endif
+  for (; k < bytes; ++k) {
+    count += text[k] == '\n';
+  }
+  return count;
+}
+
+TextBoard::TextBoard(const char* filename) {
+  filename_ = filename;
+  data_ = nullptr;
+  size_ = 0;
+  body_ = 0;
+  rows_ = 0;
+  cols_ = 0;
+
+  int fd = open(filename, O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    fail("No se pudo abrir el archivo " + std::string(filename));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return;
+  }
+  size_ = info.st_size;
+  if (size_ > 0) {
+    void* region = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region != MAP_FAILED) {
+      data_ = static_cast<const char*>(region);
+      // cada hilo recorre su trozo en orden
+      madvise(region, size_, MADV_SEQUENTIAL);
+    }
+  }
+  close(fd);
+  if (data_ == nullptr) {
+    fail("No se pudo abrir el archivo " + std::string(filename));
+    size_ = 0;
+    return;
+  }
+
+  // Cabecera: filas y columnas en la primera línea
+  const char* newline = static_cast<const char*>(std::memchr(data_, '\n', size_));
+  body_ = newline != nullptr ? newline - data_ + 1 : size_;
+  std::istringstream dimensions(std::string(data_, newline != nullptr ? newline - data_ : size_));
+  if (!(dimensions >> rows_ >> cols_) || rows_ < 0 || cols_ < 0) {
+    fail("Cabecera no válida en el archivo " + std::string(filename));
+    rows_ = 0;
+    cols_ = 0;
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+  }
+}
+
+TextBoard::~TextBoard() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+bool TextBoard::isOpen() const {
+  return data_ != nullptr;
+}
+
+const std::string& TextBoard::getError() const {
+  return error_;
+}
+
+void TextBoard::fail(const std::string& message) {
+  error_ = message;
+  std::cerr << "Error: " << message << std::endl;
+}
+
+int TextBoard::getRows() const {
+  return rows_;
+}
+
+int TextBoard::getCols() const {
+  return cols_;
+}
+
+bool TextBoard::pack(std::uint64_t* out, std::size_t stride, int threads) {
+  if (data_ == nullptr) {
+    return false;
+  }
+  const std::size_t bodyBytes = size_ - body_;
+  if (threads <= 0) {
+    threads = std::max(1, static_cast<int>(std::min<std::size_t>(std::thread::hardware_concurrency(),
+                                                                 bodyBytes / kBytesPerThread)));
+  }
+  threads = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, bodyBytes)));
+
+  // Trozos iguales del texto; la fila que empieza en un trozo la empaqueta su hilo
+  std::vector<std::size_t> begin(threads + 1);
+  for (int t = 0; t <= threads; ++t) {
+    begin[t] = body_ + bodyBytes * t / threads;
+  }
+
+  // Primera pasada: saltos de línea de cada trozo, para saber en qué fila empieza
+  std::vector<std::size_t> firstRow(threads + 1, 0);
+  {
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+      workers.emplace_back([&, t]() { firstRow[t + 1] = countNewlines(data_ + begin[t], begin[t + 1] - begin[t]); });
+    }
+    firstRow[1] = countNewlines(data_ + begin[0], begin[1] - begin[0]);
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+  for (int t = 1; t <= threads; ++t) {
+    firstRow[t] += firstRow[t - 1];
+  }
+
+  // Segunda pasada: cada hilo empaqueta sus filas y recuerda la primera incorrecta
+  const std::size_t none = static_cast<std::size_t>(-1);
+  std::vector<std::size_t> badRow(threads, none);
+  std::vector<std::size_t> badLength(threads, 0);
+  auto packChunk = [&](int t) {
+    std::size_t start = begin[t];
+    std::size_t row = firstRow[t];
+    if (t > 0 && data_[start - 1] != '\n') {
+      // la fila anterior sigue en este trozo: se salta hasta el siguiente salto
+      const void* newline = std::memchr(data_ + start, '\n', begin[t + 1] - start);
+      if (newline == nullptr) {
+        return;
+      }
+      start = static_cast<const char*>(newline) - data_ + 1;
+      ++row;
+    }
+    while (start < begin[t + 1] && row < static_cast<std::size_t>(rows_)) {
+      const void* newline = std::memchr(data_ + start, '\n', size_ - start);
+      const std::size_t end = newline != nullptr ? static_cast<const char*>(newline) - data_ : size_;
+      if (end - start != static_cast<std::size_t>(cols_)) {
+        // las filas siguientes de este trozo ya no pueden ser la primera incorrecta
+        badRow[t] = row;
+        badLength[t] = end - start;
+        return;
+      }
+      packTextRow(data_ + start, cols_, out + row * stride);
+      start = end + 1;
+      ++row;
+    }
+  };
+  {
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+      workers.emplace_back(packChunk, t);
+    }
+    packChunk(0);
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // Filas presentes: una por salto de línea, más la última si no termina en uno
+  const std::size_t present = firstRow[threads] + (bodyBytes > 0 && data_[size_ - 1] != '\n' ? 1 : 0);
+  // los trozos van en orden, así que el primer error encontrado es la primera fila incorrecta
+  for (int t = 0; t < threads; ++t) {
+    if (badRow[t] != none && badRow[t] < present) {
+      fail("La longitud de la fila " + std::to_string(badRow[t]) + " (" + std::to_string(badLength[t]) +
+           " caracteres) no coincide con el número de columnas especificado (" + std::to_string(cols_) + ").");
+      return false;
+    }
+  }
+  if (present < static_cast<std::size_t>(rows_)) {
+    fail("El archivo " + std::string(filename_) + " solo tiene " + std::to_string(present) + " de las " +
+         std::to_string(rows_) + " filas.");
+    return false;
+  }
+  return true;
+}
+
+bool TextBoard::pack(Bitboard& board, int threads) {
+  if (board.getRows() != rows_ || board.getCols() != cols_) {
+    fail("El tablero no tiene las dimensiones del archivo " + std::string(filename_));
+    return false;
+  }
+  // el interior de cada fila empieza en la palabra 1 con la columna 0 en el bit 0
+  return pack(board.row(0) + 1, board.getStride(), threads);
+}
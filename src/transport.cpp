@@ -0,0 +1,344 @@
+#include "transport.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool parseTransport(const std::string& nombre, TransportKind& kind) {
+  if (nombre == "socket") {
+    kind = TransportKind::socket;
+  } else if (nombre == "shm") {
+    kind = TransportKind::sharedMemory;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Recorre los enlaces de la rejilla: cada trabajador crea el de abajo y el de
+// la derecha, y el vecino correspondiente recibe el otro extremo como arriba/izquierda
+template <typename F>
+static void forEachLink(int procRows, int procCols, bool periodic, F link) {
+  for (int p = 0; p < procRows; ++p) {
+    for (int q = 0; q < procCols; ++q) {
+      if (p + 1 < procRows || periodic) {
+        link(p * procCols + q, kDown, ((p + 1) % procRows) * procCols + q, kUp);
+      }
+      if (q + 1 < procCols || periodic) {
+        link(p * procCols + q, kRight, p * procCols + (q + 1) % procCols, kLeft);
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Sockets de dominio Unix
+
+class SocketTransport : public Transport {
+public:
+  explicit SocketTransport(const std::array<int, 4>& fds) : fds_(fds) {
+    for (auto& pending : pending_) {
+      pending = Pending();
+    }
+  }
+
+  ~SocketTransport() override {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  bool hasLink(int dir) const override {
+    return fds_[dir] >= 0;
+  }
+
+  void post(int dir, const void* out, void* in, std::size_t bytes) override {
+    Pending& pending = pending_[dir];
+    pending.out = static_cast<const char*>(out);
+    pending.in = static_cast<char*>(in);
+    pending.bytes = bytes;
+    pending.sent = 0;
+    pending.received = 0;
+    pending.active = true;
+    // lo que quepa en el búfer del socket sale ya, sin esperar a wait()
+    progress(dir);
+  }
+
+  void wait() override {
+    while (true) {
+      struct pollfd fds[4];
+      int count = 0;
+      for (int dir = 0; dir < 4; ++dir) {
+        if (!progress(dir)) {
+          fds[count].fd = fds_[dir];
+          fds[count].events = 0;
+          if (pending_[dir].sent < pending_[dir].bytes) {
+            fds[count].events |= POLLOUT;
+          }
+          if (pending_[dir].received < pending_[dir].bytes) {
+            fds[count].events |= POLLIN;
+          }
+          fds[count++].revents = 0;
+        }
+      }
+      if (count == 0) {
+        return;
+      }
+      if (poll(fds, count, -1) < 0 && errno != EINTR) {
+        throw std::runtime_error("Error en poll() durante el intercambio de halos.");
+      }
+    }
+  }
+
+private:
+  struct Pending {
+    const char* out = nullptr;
+    char* in = nullptr;
+    std::size_t bytes = 0;
+    std::size_t sent = 0;
+    std::size_t received = 0;
+    bool active = false;
+  };
+
+  // Avanza el intercambio sin bloquear. Devuelve true si ya ha terminado.
+  bool progress(int dir) {
+    Pending& pending = pending_[dir];
+    if (!pending.active) {
+      return true;
+    }
+    while (pending.sent < pending.bytes) {
+      ssize_t n = send(fds_[dir], pending.out + pending.sent, pending.bytes - pending.sent, MSG_NOSIGNAL);
+      if (n > 0) {
+        pending.sent += n;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        break;
+      } else {
+        throw std::runtime_error("Error al enviar el halo a un vecino.");
+      }
+    }
+    while (pending.received < pending.bytes) {
+      ssize_t n = recv(fds_[dir], pending.in + pending.received, pending.bytes - pending.received, 0);
+      if (n > 0) {
+        pending.received += n;
+      } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        break;
+      } else {
+        throw std::runtime_error("Un vecino ha cerrado el enlace durante el intercambio de halos.");
+      }
+    }
+    pending.active = pending.sent < pending.bytes || pending.received < pending.bytes;
+    return !pending.active;
+  }
+
+  std::array<int, 4> fds_;
+  Pending pending_[4];
+};
+
+class SocketNetwork : public TransportNetwork {
+public:
+  SocketNetwork(int procRows, int procCols, bool periodic) {
+    procCols_ = procCols;
+    std::array<int, 4> none = {{-1, -1, -1, -1}};
+    fds_.assign(procRows * procCols, none);
+    forEachLink(procRows, procCols, periodic, [this](int a, int dirA, int b, int dirB) {
+      int sv[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+        throw std::runtime_error("No se pudo crear el socketpair de un enlace.");
+      }
+      fcntl(sv[0], F_SETFL, O_NONBLOCK);
+      fcntl(sv[1], F_SETFL, O_NONBLOCK);
+      fds_[a][dirA] = sv[0];
+      fds_[b][dirB] = sv[1];
+    });
+  }
+
+  ~SocketNetwork() override {
+    release();
+  }
+
+  std::unique_ptr<Transport> endpoint(int p, int q) override {
+    const int worker = p * procCols_ + q;
+    // el hijo se queda solo con sus extremos
+    std::array<int, 4> mine = fds_[worker];
+    fds_[worker] = {{-1, -1, -1, -1}};
+    release();
+    return std::unique_ptr<Transport>(new SocketTransport(mine));
+  }
+
+  void release() override {
+    for (auto& worker : fds_) {
+      for (int& fd : worker) {
+        if (fd >= 0) {
+          close(fd);
+          fd = -1;
+        }
+      }
+    }
+  }
+
+private:
+  int procCols_;
+  std::vector<std::array<int, 4>> fds_;
+};
+
+// ---------------------------------------------------------------------------
+// Memoria compartida: cada enlace tiene un buzón por sentido con dos huecos,
+// así el emisor puede adelantar un mensaje mientras el receptor lee el anterior
+
+struct Mailbox {
+  std::atomic<std::uint64_t> seq; // mensajes escritos
+  std::atomic<std::uint64_t> ack; // mensajes leídos
+};
+
+static const std::size_t kMailboxHeader = 64;
+
+static inline void spinWait(int& spins) {
+  if (++spins > 64) {
+    sched_yield();
+  }
+}
+
+class ShmTransport : public Transport {
+public:
+  ShmTransport(const std::array<char*, 4>& outbox, const std::array<char*, 4>& inbox, std::size_t capacity)
+      : outbox_(outbox), inbox_(inbox), capacity_(capacity) {
+    for (int dir = 0; dir < 4; ++dir) {
+      sent_[dir] = 0;
+      received_[dir] = 0;
+      pendingIn_[dir] = nullptr;
+      pendingBytes_[dir] = 0;
+    }
+  }
+
+  bool hasLink(int dir) const override {
+    return outbox_[dir] != nullptr;
+  }
+
+  void post(int dir, const void* out, void* in, std::size_t bytes) override {
+    Mailbox* box = reinterpret_cast<Mailbox*>(outbox_[dir]);
+    const std::uint64_t m = sent_[dir];
+    // el hueco m % 2 queda libre cuando se ha leído el mensaje m - 2
+    int spins = 0;
+    while (m >= 2 && box->ack.load(std::memory_order_acquire) < m - 1) {
+      spinWait(spins);
+    }
+    std::memcpy(slot(outbox_[dir], m), out, bytes);
+    box->seq.store(m + 1, std::memory_order_release);
+    ++sent_[dir];
+
+    pendingIn_[dir] = static_cast<char*>(in);
+    pendingBytes_[dir] = bytes;
+  }
+
+  void wait() override {
+    for (int dir = 0; dir < 4; ++dir) {
+      if (pendingIn_[dir] == nullptr) {
+        continue;
+      }
+      Mailbox* box = reinterpret_cast<Mailbox*>(inbox_[dir]);
+      const std::uint64_t m = received_[dir];
+      int spins = 0;
+      while (box->seq.load(std::memory_order_acquire) < m + 1) {
+        spinWait(spins);
+      }
+      std::memcpy(pendingIn_[dir], slot(inbox_[dir], m), pendingBytes_[dir]);
+      box->ack.store(m + 1, std::memory_order_release);
+      ++received_[dir];
+      pendingIn_[dir] = nullptr;
+    }
+  }
+
+private:
+  char* slot(char* box, std::uint64_t m) const {
+    return box + kMailboxHeader + (m % 2) * capacity_;
+  }
+
+  std::array<char*, 4> outbox_;
+  std::array<char*, 4> inbox_;
+  std::size_t capacity_;
+  std::uint64_t sent_[4];
+  std::uint64_t received_[4];
+  char* pendingIn_[4];
+  std::size_t pendingBytes_[4];
+};
+
+class ShmNetwork : public TransportNetwork {
+public:
+  ShmNetwork(int procRows, int procCols, bool periodic, std::size_t maxMessage) {
+    procCols_ = procCols;
+    capacity_ = (maxMessage + 63) / 64 * 64;
+    const std::size_t boxBytes = kMailboxHeader + 2 * capacity_;
+
+    int links = 0;
+    forEachLink(procRows, procCols, periodic, [&links](int, int, int, int) { ++links; });
+
+    size_ = std::max<std::size_t>(1, 2 * links * boxBytes);
+    void* region = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+      throw std::runtime_error("No se pudo reservar la memoria compartida de los enlaces.");
+    }
+    region_ = static_cast<char*>(region);
+
+    std::array<char*, 4> none = {{nullptr, nullptr, nullptr, nullptr}};
+    outbox_.assign(procRows * procCols, none);
+    inbox_.assign(procRows * procCols, none);
+
+    char* next = region_;
+    forEachLink(procRows, procCols, periodic, [&](int a, int dirA, int b, int dirB) {
+      char* ab = next;
+      char* ba = next + boxBytes;
+      next += 2 * boxBytes;
+      new (ab) Mailbox{{0}, {0}};
+      new (ba) Mailbox{{0}, {0}};
+      outbox_[a][dirA] = ab;
+      inbox_[b][dirB] = ab;
+      outbox_[b][dirB] = ba;
+      inbox_[a][dirA] = ba;
+    });
+  }
+
+  ~ShmNetwork() override {
+    release();
+  }
+
+  std::unique_ptr<Transport> endpoint(int p, int q) override {
+    const int worker = p * procCols_ + q;
+    // la región sigue proyectada en el hijo hasta que termina
+    return std::unique_ptr<Transport>(new ShmTransport(outbox_[worker], inbox_[worker], capacity_));
+  }
+
+  void release() override {
+    if (region_ != nullptr) {
+      munmap(region_, size_);
+      region_ = nullptr;
+    }
+  }
+
+private:
+  int procCols_;
+  std::size_t capacity_;
+  std::size_t size_;
+  char* region_ = nullptr;
+  std::vector<std::array<char*, 4>> outbox_;
+  std::vector<std::array<char*, 4>> inbox_;
+};
+
+std::unique_ptr<TransportNetwork> makeTransportNetwork(TransportKind kind, int procRows, int procCols,
+                                                       bool periodic, std::size_t maxMessage) {
+  if (kind == TransportKind::socket) {
+    return std::unique_ptr<TransportNetwork>(new SocketNetwork(procRows, procCols, periodic));
+  }
+  return std::unique_ptr<TransportNetwork>(new ShmNetwork(procRows, procCols, periodic, maxMessage));
+}
@@ -0,0 +1,52 @@
+#include "viewport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Glifos de menos a más densidad; el primero es un bloque sin células vivas
+static const char kGlyphs[] = " .:-=+*#%@";
+static const int kLevels = sizeof(kGlyphs) - 1;
+
+int fitZoom(int rows, int cols, int height, int width) {
+  height = std::max(height, 1);
+  width = std::max(width, 1);
+  return std::max(1, std::max((rows + height - 1) / height, (cols + width - 1) / width));
+}
+
+void renderViewport(const Bitboard& board, const Viewport& view, int height, int width,
+                    std::string& out, const char* lineEnd) {
+  const int zoom = std::max(view.zoom, 1);
+  const int top = std::min(std::max(view.row, 0), board.getRows());
+  const int left = std::min(std::max(view.col, 0), board.getCols());
+  // parte de la ventana que cae dentro del tablero
+  const int lines = std::min(height, (board.getRows() - top + zoom - 1) / zoom);
+  const int chars = std::min(width, (board.getCols() - left + zoom - 1) / zoom);
+  const std::size_t lineEndLength = std::strlen(lineEnd);
+  out.reserve(out.size() + static_cast<std::size_t>(std::max(lines, 0)) * (std::max(chars, 0) + lineEndLength));
+
+  std::vector<int> counts(std::max(chars, 0));
+  for (int r = 0; r < lines; ++r) {
+    const int rowBegin = top + r * zoom;
+    const int rowEnd = std::min(rowBegin + zoom, board.getRows());
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int i = rowBegin; i < rowEnd; ++i) {
+      for (int c = 0; c < chars; ++c) {
+        const int colBegin = left + c * zoom;
+        counts[c] += board.countRange(i, colBegin, std::min(colBegin + zoom, board.getCols()));
+      }
+    }
+
+    for (int c = 0; c < chars; ++c) {
+      if (zoom == 1) {
+        out += counts[c] ? 'X' : '-';
+        continue;
+      }
+      const int colBegin = left + c * zoom;
+      const int cells = (rowEnd - rowBegin) * (std::min(colBegin + zoom, board.getCols()) - colBegin);
+      // cualquier célula viva se ve; el bloque lleno da el último glifo
+      out += counts[c] == 0 ? kGlyphs[0] : kGlyphs[1 + counts[c] * (kLevels - 2) / cells];
+    }
+    out.append(lineEnd, lineEndLength);
+  }
+}